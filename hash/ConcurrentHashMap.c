@@ -0,0 +1,431 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+#define INITIAL_SEGMENT_CAPACITY 16
+#define LOAD_FACTOR_THRESHOLD 0.75
+#define DEFAULT_SEGMENTS 64
+#define CACHE_LINE_SIZE 64
+
+typedef struct Entry {
+    char *key;
+    uint64_t hash;
+    int value;
+    struct Entry *next;
+} Entry;
+
+// Each segment is an independent chained table with its own lock and its own
+// resize, aligned so neighbouring locks never share a cache line
+typedef struct Segment {
+    pthread_mutex_t lock;
+    Entry **buckets;
+    int capacity;
+    int size;
+} __attribute__((aligned(CACHE_LINE_SIZE))) Segment;
+
+typedef struct ConcurrentHashMap {
+    Segment *segments;
+    int numSegments;    // Power of two; 1 segment is a plain single-mutex map
+    int segmentShift;
+} ConcurrentHashMap;
+
+// 64x64 -> 128-bit multiply folded back to 64 bits
+static inline uint64_t mulFold(uint64_t a, uint64_t b) {
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+// wyhash-style hash, same as HashMap.c's default
+uint64_t hash(const char *key) {
+    size_t length = strlen(key);
+    uint64_t hashValue = 0xa0761d6478bd642fULL;
+    uint64_t word;
+
+    while (length >= 8) {
+        memcpy(&word, key, 8);
+        hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL);
+        key += 8;
+        length -= 8;
+    }
+
+    word = 0;
+    memcpy(&word, key, length);
+    hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL ^ length);
+    return mulFold(hashValue, 0x8ebc6af09c88c6e3ULL);
+}
+
+// Top bits pick the segment, low bits pick the bucket inside it
+Segment* segmentFor(ConcurrentHashMap *map, uint64_t hashValue) {
+    return &map->segments[map->numSegments == 1 ? 0 : hashValue >> map->segmentShift];
+}
+
+// Create a new entry
+Entry* createEntry(const char *key, uint64_t hashValue, int value) {
+    Entry *entry = (Entry*)malloc(sizeof(Entry));
+    entry->key = (char*)malloc(strlen(key) + 1);
+    strcpy(entry->key, key);
+    entry->hash = hashValue;
+    entry->value = value;
+    entry->next = NULL;
+    return entry;
+}
+
+// Initialize hash map split into numSegments independently locked segments
+ConcurrentHashMap* createConcurrentHashMap(int numSegments) {
+    int rounded = 1;
+    while (rounded < numSegments)
+        rounded *= 2;
+
+    ConcurrentHashMap *map = (ConcurrentHashMap*)malloc(sizeof(ConcurrentHashMap));
+    map->numSegments = rounded;
+    map->segmentShift = 64 - __builtin_ctz(rounded);
+    map->segments = (Segment*)aligned_alloc(CACHE_LINE_SIZE, rounded * sizeof(Segment));
+
+    for (int i = 0; i < rounded; i++) {
+        Segment *segment = &map->segments[i];
+        pthread_mutex_init(&segment->lock, NULL);
+        segment->capacity = INITIAL_SEGMENT_CAPACITY;
+        segment->size = 0;
+        segment->buckets = (Entry**)calloc(segment->capacity, sizeof(Entry*));
+    }
+
+    return map;
+}
+
+// Initialize hash map
+ConcurrentHashMap* createHashMap() {
+    return createConcurrentHashMap(DEFAULT_SEGMENTS);
+}
+
+// Resize and rehash one segment (caller holds its lock)
+void resizeSegment(Segment *segment) {
+    int oldCapacity = segment->capacity;
+    Entry **oldBuckets = segment->buckets;
+
+    segment->capacity *= 2;
+    segment->buckets = (Entry**)calloc(segment->capacity, sizeof(Entry*));
+
+    for (int i = 0; i < oldCapacity; i++) {
+        Entry *entry = oldBuckets[i];
+        while (entry != NULL) {
+            Entry *next = entry->next;
+            unsigned int index = entry->hash & (segment->capacity - 1);
+            entry->next = segment->buckets[index];
+            segment->buckets[index] = entry;
+            entry = next;
+        }
+    }
+
+    free(oldBuckets);
+}
+
+// Find an entry in a segment (caller holds its lock)
+Entry* findEntry(Segment *segment, const char *key, uint64_t hashValue) {
+    Entry *entry = segment->buckets[hashValue & (segment->capacity - 1)];
+
+    while (entry != NULL) {
+        if (entry->hash == hashValue && strcmp(entry->key, key) == 0)
+            return entry;
+        entry = entry->next;
+    }
+
+    return NULL;
+}
+
+// Put a key-value pair into the map
+void put(ConcurrentHashMap *map, const char *key, int value) {
+    uint64_t hashValue = hash(key);
+    Segment *segment = segmentFor(map, hashValue);
+
+    pthread_mutex_lock(&segment->lock);
+
+    Entry *entry = findEntry(segment, key, hashValue);
+    if (entry != NULL) {
+        entry->value = value;
+        pthread_mutex_unlock(&segment->lock);
+        return;
+    }
+
+    // Only this segment grows; writers to other segments are not blocked
+    if ((double)segment->size / segment->capacity >= LOAD_FACTOR_THRESHOLD)
+        resizeSegment(segment);
+
+    unsigned int index = hashValue & (segment->capacity - 1);
+    Entry *newEntry = createEntry(key, hashValue, value);
+    newEntry->next = segment->buckets[index];
+    segment->buckets[index] = newEntry;
+    segment->size++;
+
+    pthread_mutex_unlock(&segment->lock);
+}
+
+// Get value for a key
+int get(ConcurrentHashMap *map, const char *key, bool *found) {
+    uint64_t hashValue = hash(key);
+    Segment *segment = segmentFor(map, hashValue);
+    int value = -1;
+
+    pthread_mutex_lock(&segment->lock);
+    Entry *entry = findEntry(segment, key, hashValue);
+    *found = entry != NULL;
+    if (entry != NULL)
+        value = entry->value;
+    pthread_mutex_unlock(&segment->lock);
+
+    return value;
+}
+
+// Check if key exists
+bool containsKey(ConcurrentHashMap *map, const char *key) {
+    bool found;
+    get(map, key, &found);
+    return found;
+}
+
+// Remove a key-value pair
+bool removeKey(ConcurrentHashMap *map, const char *key) {
+    uint64_t hashValue = hash(key);
+    Segment *segment = segmentFor(map, hashValue);
+
+    pthread_mutex_lock(&segment->lock);
+
+    Entry **link = &segment->buckets[hashValue & (segment->capacity - 1)];
+    while (*link != NULL) {
+        Entry *entry = *link;
+        if (entry->hash == hashValue && strcmp(entry->key, key) == 0) {
+            *link = entry->next;
+            segment->size--;
+            pthread_mutex_unlock(&segment->lock);
+
+            free(entry->key);
+            free(entry);
+            return true;
+        }
+        link = &entry->next;
+    }
+
+    pthread_mutex_unlock(&segment->lock);
+    return false;
+}
+
+// Get size of map (each segment is counted under its own lock)
+int getSize(ConcurrentHashMap *map) {
+    int size = 0;
+
+    for (int i = 0; i < map->numSegments; i++) {
+        pthread_mutex_lock(&map->segments[i].lock);
+        size += map->segments[i].size;
+        pthread_mutex_unlock(&map->segments[i].lock);
+    }
+
+    return size;
+}
+
+// Check if map is empty
+bool isEmpty(ConcurrentHashMap *map) {
+    return getSize(map) == 0;
+}
+
+// Free the hash map (no other thread may be using it)
+void freeHashMap(ConcurrentHashMap *map) {
+    for (int i = 0; i < map->numSegments; i++) {
+        Segment *segment = &map->segments[i];
+        for (int b = 0; b < segment->capacity; b++) {
+            Entry *entry = segment->buckets[b];
+            while (entry != NULL) {
+                Entry *next = entry->next;
+                free(entry->key);
+                free(entry);
+                entry = next;
+            }
+        }
+        free(segment->buckets);
+        pthread_mutex_destroy(&segment->lock);
+    }
+
+    free(map->segments);
+    free(map);
+}
+
+// ---------------------------------------------------------------------------
+// Throughput benchmark
+// ---------------------------------------------------------------------------
+
+#define KEY_SPACE 100000
+#define INSERT_KEYS (1 << 20)  // Distinct keys for the insert-only runs (includes the first KEY_SPACE)
+
+typedef struct Worker {
+    pthread_t thread;
+    ConcurrentHashMap *map;
+    char **keys;
+    int operations;
+    int readPercent;
+    int firstKey;
+    uint64_t rng;
+} Worker;
+
+// xorshift64: cheap per-thread random numbers with no shared state
+static inline uint64_t nextRandom(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+void* runWorker(void *arg) {
+    Worker *worker = (Worker*)arg;
+    bool found;
+
+    for (int i = 0; i < worker->operations; i++) {
+        uint64_t r = nextRandom(&worker->rng);
+        const char *key = worker->keys[r % KEY_SPACE];
+
+        if ((int)((r >> 32) % 100) < worker->readPercent)
+            get(worker->map, key, &found);
+        else
+            put(worker->map, key, (int)r);
+    }
+
+    return NULL;
+}
+
+// Insert keys[firstKey, firstKey + operations), none of them present yet
+void* runInsertWorker(void *arg) {
+    Worker *worker = (Worker*)arg;
+
+    for (int i = 0; i < worker->operations; i++)
+        put(worker->map, worker->keys[worker->firstKey + i], i);
+
+    return NULL;
+}
+
+// Million inserts per second for numThreads threads filling one empty map with
+// distinct new keys, so every put allocates an entry and segments keep
+// resizing under their locks while other writers wait
+double measureInsertThroughput(int numSegments, int numThreads, char **keys, int totalInserts) {
+    ConcurrentHashMap *map = createConcurrentHashMap(numSegments);
+
+    Worker *workers = (Worker*)malloc(numThreads * sizeof(Worker));
+    struct timespec start, end;
+    int perThread = totalInserts / numThreads;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int t = 0; t < numThreads; t++) {
+        workers[t].map = map;
+        workers[t].keys = keys;
+        workers[t].operations = perThread;
+        workers[t].firstKey = t * perThread;
+        pthread_create(&workers[t].thread, NULL, runInsertWorker, &workers[t]);
+    }
+    for (int t = 0; t < numThreads; t++)
+        pthread_join(workers[t].thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    free(workers);
+    freeHashMap(map);
+    return (double)perThread * numThreads / seconds / 1e6;
+}
+
+// Million operations per second for numThreads threads sharing one map
+double measureThroughput(int numSegments, int numThreads, int readPercent, char **keys, int totalOperations) {
+    ConcurrentHashMap *map = createConcurrentHashMap(numSegments);
+    for (int i = 0; i < KEY_SPACE; i++)
+        put(map, keys[i], i);
+
+    Worker *workers = (Worker*)malloc(numThreads * sizeof(Worker));
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int t = 0; t < numThreads; t++) {
+        workers[t].map = map;
+        workers[t].keys = keys;
+        workers[t].operations = totalOperations / numThreads;
+        workers[t].readPercent = readPercent;
+        workers[t].rng = 0x9e3779b97f4a7c15ULL * (t + 1);
+        pthread_create(&workers[t].thread, NULL, runWorker, &workers[t]);
+    }
+    for (int t = 0; t < numThreads; t++)
+        pthread_join(workers[t].thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    free(workers);
+    freeHashMap(map);
+    return totalOperations / seconds / 1e6;
+}
+
+// Example usage
+int main() {
+    ConcurrentHashMap *map = createHashMap();
+
+    // Insert key-value pairs
+    printf("Inserting elements...\n");
+    put(map, "apple", 100);
+    put(map, "banana", 200);
+    put(map, "orange", 300);
+    put(map, "grape", 400);
+    put(map, "mango", 500);
+    printf("Size: %d (segments: %d)\n", getSize(map), map->numSegments);
+
+    // Get values
+    printf("\nGetting values:\n");
+    bool found;
+    int value = get(map, "banana", &found);
+    printf("banana: %s (value: %d)\n", found ? "found" : "not found", value);
+
+    value = get(map, "cherry", &found);
+    printf("cherry: %s\n", found ? "found" : "not found");
+
+    // Check if key exists
+    printf("\nContains key 'apple': %s\n", containsKey(map, "apple") ? "yes" : "no");
+
+    // Remove a key
+    printf("\nRemoving 'banana'...\n");
+    removeKey(map, "banana");
+    printf("Size after removal: %d\n", getSize(map));
+    printf("Is empty: %s\n", isEmpty(map) ? "yes" : "no");
+
+    freeHashMap(map);
+
+    // Striped map vs one global mutex (a single segment), mixed read/write loads
+    char **keys = (char**)malloc(INSERT_KEYS * sizeof(char*));
+    for (int i = 0; i < INSERT_KEYS; i++) {
+        keys[i] = (char*)malloc(20);
+        sprintf(keys[i], "key%d", i);
+    }
+
+    int threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+    int readPercents[] = {50, 90, 99};
+
+    // Mixed loads run on a prefilled map, so their writes only update values
+    printf("\nThroughput (Mops/s), %d segments vs single mutex:\n", DEFAULT_SEGMENTS);
+    printf("threads  reads   striped   single\n");
+    for (int r = 0; r < 3; r++) {
+        for (int t = 0; t < 7; t++) {
+            double striped = measureThroughput(DEFAULT_SEGMENTS, threadCounts[t], readPercents[r], keys, 1 << 20);
+            double single = measureThroughput(1, threadCounts[t], readPercents[r], keys, 1 << 20);
+            printf("%7d  %4d%%  %8.2f  %7.2f\n", threadCounts[t], readPercents[r], striped, single);
+        }
+    }
+
+    // Inserts into an empty map: allocation and per-segment resizes under contention
+    printf("\nInsert throughput (Mops/s), %d new keys into an empty map:\n", INSERT_KEYS);
+    printf("threads   striped   single\n");
+    for (int t = 0; t < 7; t++) {
+        double striped = measureInsertThroughput(DEFAULT_SEGMENTS, threadCounts[t], keys, INSERT_KEYS);
+        double single = measureInsertThroughput(1, threadCounts[t], keys, INSERT_KEYS);
+        printf("%7d  %8.2f  %7.2f\n", threadCounts[t], striped, single);
+    }
+
+    for (int i = 0; i < INSERT_KEYS; i++)
+        free(keys[i]);
+    free(keys);
+
+    return 0;
+}
@@ -0,0 +1,478 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#define SLOTS_PER_BUCKET 4
+#define INITIAL_BUCKETS 4
+#define MAX_KICKS 500
+#define STASH_SIZE 8
+
+// Each key has exactly two candidate buckets of four slots. A slot's tag is
+// 16 bits of the key's hash, so most non-matching slots are skipped without
+// touching the key, and the other bucket can be computed from (bucket, tag).
+typedef struct Bucket {
+    uint16_t tags[SLOTS_PER_BUCKET];
+    char *keys[SLOTS_PER_BUCKET];   // NULL marks a free slot
+    int values[SLOTS_PER_BUCKET];
+} Bucket;
+
+typedef struct StashEntry {
+    char *key;
+    uint16_t tag;
+    int value;
+} StashEntry;
+
+typedef struct CuckooHashMap {
+    Bucket *buckets;
+    int numBuckets;         // Power of two
+    int size;
+    StashEntry stash[STASH_SIZE];   // Items whose displacement path ran out
+    int stashSize;
+    uint64_t rng;
+} CuckooHashMap;
+
+// 64x64 -> 128-bit multiply folded back to 64 bits
+static inline uint64_t mulFold(uint64_t a, uint64_t b) {
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+// wyhash-style hash, same as HashMap.c's default
+uint64_t hash(const char *key) {
+    size_t length = strlen(key);
+    uint64_t hashValue = 0xa0761d6478bd642fULL;
+    uint64_t word;
+
+    while (length >= 8) {
+        memcpy(&word, key, 8);
+        hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL);
+        key += 8;
+        length -= 8;
+    }
+
+    word = 0;
+    memcpy(&word, key, length);
+    hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL ^ length);
+    return mulFold(hashValue, 0x8ebc6af09c88c6e3ULL);
+}
+
+// First hash function: low bits of the key hash
+uint32_t primaryBucket(CuckooHashMap *map, uint64_t hashValue) {
+    return (uint32_t)(hashValue & (map->numBuckets - 1));
+}
+
+uint16_t tagOf(uint64_t hashValue) {
+    return (uint16_t)(hashValue >> 48);
+}
+
+// Second hash function: the other bucket, derived from the current one and the
+// tag. Applying it twice returns the original bucket.
+uint32_t alternateBucket(CuckooHashMap *map, uint32_t bucket, uint16_t tag) {
+    return (bucket ^ (uint32_t)mulFold(tag + 1, 0x5bd1e9955bd1e995ULL)) & (map->numBuckets - 1);
+}
+
+// Initialize hash map with numBuckets buckets (rounded up to a power of two)
+CuckooHashMap* createHashMapWithBuckets(int numBuckets) {
+    int rounded = 2;
+    while (rounded < numBuckets)
+        rounded *= 2;
+
+    CuckooHashMap *map = (CuckooHashMap*)malloc(sizeof(CuckooHashMap));
+    map->numBuckets = rounded;
+    map->buckets = (Bucket*)calloc(rounded, sizeof(Bucket));
+    map->size = 0;
+    map->stashSize = 0;
+    map->rng = 0x9e3779b97f4a7c15ULL;
+    return map;
+}
+
+// Initialize hash map
+CuckooHashMap* createHashMap() {
+    return createHashMapWithBuckets(INITIAL_BUCKETS);
+}
+
+// Get load factor (occupied slots over all slots)
+double getLoadFactor(CuckooHashMap *map) {
+    return (double)map->size / (map->numBuckets * SLOTS_PER_BUCKET);
+}
+
+// Slot index of key in a bucket, or -1
+int findInBucket(Bucket *bucket, const char *key, uint16_t tag) {
+    for (int i = 0; i < SLOTS_PER_BUCKET; i++) {
+        if (bucket->keys[i] != NULL && bucket->tags[i] == tag && strcmp(bucket->keys[i], key) == 0)
+            return i;
+    }
+    return -1;
+}
+
+// Store an item in a free slot of the bucket if there is one
+bool placeInBucket(Bucket *bucket, char *key, uint16_t tag, int value) {
+    for (int i = 0; i < SLOTS_PER_BUCKET; i++) {
+        if (bucket->keys[i] == NULL) {
+            bucket->keys[i] = key;
+            bucket->tags[i] = tag;
+            bucket->values[i] = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// xorshift64 for picking which slot to evict
+static inline uint64_t nextRandom(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+// Place an item that is known not to be in the map. Random-walk displacement:
+// evict a random occupant, move it to its other bucket, repeat. Returns false
+// only if the walk ran out and the stash is full; the item left without a slot
+// is written to homeless and the map must grow before it can be placed.
+bool insertItem(CuckooHashMap *map, char *key, uint16_t tag, uint32_t bucket, int value, StashEntry *homeless) {
+    uint32_t other = alternateBucket(map, bucket, tag);
+    if (placeInBucket(&map->buckets[bucket], key, tag, value) ||
+        placeInBucket(&map->buckets[other], key, tag, value))
+        return true;
+
+    uint32_t current = (nextRandom(&map->rng) & 1) ? bucket : other;
+    for (int kick = 0; kick < MAX_KICKS; kick++) {
+        int victim = (int)(nextRandom(&map->rng) % SLOTS_PER_BUCKET);
+        Bucket *b = &map->buckets[current];
+
+        char *evictedKey = b->keys[victim];
+        uint16_t evictedTag = b->tags[victim];
+        int evictedValue = b->values[victim];
+        b->keys[victim] = key;
+        b->tags[victim] = tag;
+        b->values[victim] = value;
+
+        key = evictedKey;
+        tag = evictedTag;
+        value = evictedValue;
+        current = alternateBucket(map, current, tag);
+
+        if (placeInBucket(&map->buckets[current], key, tag, value))
+            return true;
+    }
+
+    // The item left in hand goes to the stash
+    StashEntry *entry = map->stashSize < STASH_SIZE ? &map->stash[map->stashSize++] : homeless;
+    entry->key = key;
+    entry->tag = tag;
+    entry->value = value;
+    return entry != homeless;
+}
+
+// Double the number of buckets and reinsert every item (keys are moved, not copied)
+void resize(CuckooHashMap *map) {
+    int oldNumBuckets = map->numBuckets;
+    Bucket *oldBuckets = map->buckets;
+    StashEntry oldStash[STASH_SIZE];
+    int oldStashSize = map->stashSize;
+    memcpy(oldStash, map->stash, sizeof(oldStash));
+    StashEntry homeless;
+
+    for (;;) {
+        map->numBuckets *= 2;
+        map->buckets = (Bucket*)calloc(map->numBuckets, sizeof(Bucket));
+        map->stashSize = 0;
+        bool ok = true;
+
+        // The primary bucket gains one more hash bit, so it is recomputed from the key
+        for (int i = 0; i < oldNumBuckets && ok; i++) {
+            for (int s = 0; s < SLOTS_PER_BUCKET && ok; s++) {
+                Bucket *b = &oldBuckets[i];
+                if (b->keys[s] != NULL)
+                    ok = insertItem(map, b->keys[s], b->tags[s], primaryBucket(map, hash(b->keys[s])),
+                                    b->values[s], &homeless);
+            }
+        }
+        for (int i = 0; i < oldStashSize && ok; i++)
+            ok = insertItem(map, oldStash[i].key, oldStash[i].tag, primaryBucket(map, hash(oldStash[i].key)),
+                            oldStash[i].value, &homeless);
+
+        if (ok)
+            break;
+
+        // Extremely unlikely: grow again from the untouched old contents
+        free(map->buckets);
+    }
+
+    free(oldBuckets);
+}
+
+// Put a key-value pair into the map
+void put(CuckooHashMap *map, const char *key, int value) {
+    uint64_t hashValue = hash(key);
+    uint16_t tag = tagOf(hashValue);
+    uint32_t b1 = primaryBucket(map, hashValue);
+    uint32_t b2 = alternateBucket(map, b1, tag);
+
+    // Update if key already exists
+    int slot = findInBucket(&map->buckets[b1], key, tag);
+    if (slot >= 0) {
+        map->buckets[b1].values[slot] = value;
+        return;
+    }
+    slot = findInBucket(&map->buckets[b2], key, tag);
+    if (slot >= 0) {
+        map->buckets[b2].values[slot] = value;
+        return;
+    }
+    for (int i = 0; i < map->stashSize; i++) {
+        if (strcmp(map->stash[i].key, key) == 0) {
+            map->stash[i].value = value;
+            return;
+        }
+    }
+
+    char *keyCopy = (char*)malloc(strlen(key) + 1);
+    strcpy(keyCopy, key);
+    map->size++;
+
+    // Displacement path exhausted with a full stash: grow, then place the item
+    // that was left over
+    StashEntry homeless;
+    if (insertItem(map, keyCopy, tag, b1, value, &homeless))
+        return;
+    do {
+        resize(map);
+    } while (!insertItem(map, homeless.key, homeless.tag, primaryBucket(map, hash(homeless.key)),
+                         homeless.value, &homeless));
+}
+
+// Get value for a key: at most two bucket reads (plus the stash when not empty)
+int get(CuckooHashMap *map, const char *key, bool *found) {
+    uint64_t hashValue = hash(key);
+    uint16_t tag = tagOf(hashValue);
+    uint32_t b1 = primaryBucket(map, hashValue);
+
+    int slot = findInBucket(&map->buckets[b1], key, tag);
+    if (slot >= 0) {
+        *found = true;
+        return map->buckets[b1].values[slot];
+    }
+
+    uint32_t b2 = alternateBucket(map, b1, tag);
+    slot = findInBucket(&map->buckets[b2], key, tag);
+    if (slot >= 0) {
+        *found = true;
+        return map->buckets[b2].values[slot];
+    }
+
+    for (int i = 0; i < map->stashSize; i++) {
+        if (map->stash[i].tag == tag && strcmp(map->stash[i].key, key) == 0) {
+            *found = true;
+            return map->stash[i].value;
+        }
+    }
+
+    *found = false;
+    return -1;
+}
+
+// Check if key exists
+bool containsKey(CuckooHashMap *map, const char *key) {
+    bool found;
+    get(map, key, &found);
+    return found;
+}
+
+// Remove a key-value pair
+bool removeKey(CuckooHashMap *map, const char *key) {
+    uint64_t hashValue = hash(key);
+    uint16_t tag = tagOf(hashValue);
+    uint32_t candidates[2];
+    candidates[0] = primaryBucket(map, hashValue);
+    candidates[1] = alternateBucket(map, candidates[0], tag);
+
+    for (int c = 0; c < 2; c++) {
+        Bucket *b = &map->buckets[candidates[c]];
+        int slot = findInBucket(b, key, tag);
+        if (slot >= 0) {
+            free(b->keys[slot]);
+            b->keys[slot] = NULL;
+            map->size--;
+            return true;
+        }
+    }
+
+    for (int i = 0; i < map->stashSize; i++) {
+        if (strcmp(map->stash[i].key, key) == 0) {
+            free(map->stash[i].key);
+            map->stash[i] = map->stash[--map->stashSize];
+            map->size--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Clear all entries
+void clear(CuckooHashMap *map) {
+    for (int i = 0; i < map->numBuckets; i++) {
+        for (int s = 0; s < SLOTS_PER_BUCKET; s++) {
+            free(map->buckets[i].keys[s]);
+            map->buckets[i].keys[s] = NULL;
+        }
+    }
+    for (int i = 0; i < map->stashSize; i++)
+        free(map->stash[i].key);
+    map->stashSize = 0;
+    map->size = 0;
+}
+
+// Check if map is empty
+bool isEmpty(CuckooHashMap *map) {
+    return map->size == 0;
+}
+
+// Get size of map
+int getSize(CuckooHashMap *map) {
+    return map->size;
+}
+
+// Print the hash map
+void printHashMap(CuckooHashMap *map) {
+    printf("CuckooHashMap (size: %d, buckets: %d x %d, load factor: %.2f, stash: %d):\n",
+           map->size, map->numBuckets, SLOTS_PER_BUCKET, getLoadFactor(map), map->stashSize);
+
+    for (int i = 0; i < map->numBuckets; i++) {
+        printf("Bucket %d: ", i);
+        for (int s = 0; s < SLOTS_PER_BUCKET; s++) {
+            if (map->buckets[i].keys[s] != NULL)
+                printf("[%s: %d] ", map->buckets[i].keys[s], map->buckets[i].values[s]);
+        }
+        printf("\n");
+    }
+
+    for (int i = 0; i < map->stashSize; i++)
+        printf("Stash: [%s: %d]\n", map->stash[i].key, map->stash[i].value);
+}
+
+// Free the hash map
+void freeHashMap(CuckooHashMap *map) {
+    clear(map);
+    free(map->buckets);
+    free(map);
+}
+
+// Occupancy reached before each growth, and lookup latency at the final size
+void benchmark(int n) {
+    char **keys = (char**)malloc(n * sizeof(char*));
+    for (int i = 0; i < n; i++) {
+        keys[i] = (char*)malloc(20);
+        sprintf(keys[i], "key%d", i);
+    }
+
+    CuckooHashMap *map = createHashMap();
+    double minFullness = 1.0;
+    int lastBuckets = map->numBuckets;
+
+    for (int i = 0; i < n; i++) {
+        int before = map->size;
+        put(map, keys[i], i);
+        if (map->numBuckets != lastBuckets) {
+            // Load factor the table reached just before this insert forced a resize
+            double fullness = (double)before / (lastBuckets * SLOTS_PER_BUCKET);
+            if (lastBuckets >= 1024 && fullness < minFullness)
+                minFullness = fullness;
+            lastBuckets = map->numBuckets;
+        }
+    }
+
+    struct timespec start, end;
+    long hits = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++)
+        hits += containsKey(map, keys[(int)((uint64_t)i * 2654435761u % n)]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double hitNs = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / n;
+
+    char miss[24];
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) {
+        sprintf(miss, "miss%d", i);
+        hits += containsKey(map, miss);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double missNs = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / n;
+
+    printf("%d keys: lowest occupancy at a resize %.1f%%, final %.1f%%, stash %d\n",
+           n, 100 * minFullness, 100 * getLoadFactor(map), map->stashSize);
+    printf("hit %.1f ns, miss %.1f ns (hits: %ld)\n", hitNs, missNs, hits);
+
+    freeHashMap(map);
+    for (int i = 0; i < n; i++)
+        free(keys[i]);
+    free(keys);
+}
+
+// Example usage
+int main() {
+    CuckooHashMap *map = createHashMap();
+
+    // Insert key-value pairs
+    printf("Inserting elements...\n");
+    put(map, "apple", 100);
+    put(map, "banana", 200);
+    put(map, "orange", 300);
+    put(map, "grape", 400);
+    put(map, "mango", 500);
+
+    printHashMap(map);
+
+    // Get values
+    printf("\nGetting values:\n");
+    bool found;
+    int value = get(map, "banana", &found);
+    printf("banana: %s (value: %d)\n", found ? "found" : "not found", value);
+
+    value = get(map, "cherry", &found);
+    printf("cherry: %s\n", found ? "found" : "not found");
+
+    // Check if key exists
+    printf("\nContains key 'apple': %s\n", containsKey(map, "apple") ? "yes" : "no");
+    printf("Contains key 'cherry': %s\n", containsKey(map, "cherry") ? "yes" : "no");
+
+    // Update value
+    printf("\nUpdating 'apple' to 150...\n");
+    put(map, "apple", 150);
+    value = get(map, "apple", &found);
+    printf("apple: %d\n", value);
+
+    // Remove a key
+    printf("\nRemoving 'banana'...\n");
+    removeKey(map, "banana");
+    printf("Size after removal: %d\n", getSize(map));
+
+    // Test resizing by adding many elements
+    printf("\nAdding more elements to trigger resize...\n");
+    for (int i = 0; i < 20; i++) {
+        char key[20];
+        sprintf(key, "key%d", i);
+        put(map, key, i * 10);
+    }
+
+    printHashMap(map);
+
+    // Clear the map
+    printf("\nClearing map...\n");
+    clear(map);
+    printf("Size after clear: %d\n", getSize(map));
+    printf("Is empty: %s\n", isEmpty(map) ? "yes" : "no");
+
+    freeHashMap(map);
+
+    printf("\nBenchmark:\n");
+    benchmark(1 << 20);
+
+    return 0;
+}
@@ -0,0 +1,557 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+
+#define INITIAL_CAPACITY 16
+#define LOAD_FACTOR_THRESHOLD 0.75
+#define MAX_READERS 256
+#define CACHE_LINE_SIZE 64
+
+typedef struct Entry {
+    char *key;                      // Immutable once published
+    uint64_t hash;
+    _Atomic int value;
+    _Atomic(struct Entry*) next;
+} Entry;
+
+typedef struct Table {
+    _Atomic(Entry*) *buckets;
+    int capacity;
+} Table;
+
+// Something unlinked by a writer that readers may still be looking at
+typedef enum RetiredKind {
+    RETIRED_ENTRY,  // Removed entry: free key and node
+    RETIRED_TABLE   // Table replaced by resize(): free bucket array and its nodes
+} RetiredKind;
+
+typedef struct Retired {
+    void *pointer;
+    RetiredKind kind;
+    uint64_t epoch;
+    struct Retired *next;
+} Retired;
+
+// Readers never lock: they load the published table with acquire semantics.
+// Writers serialize on writeLock and publish with release stores.
+typedef struct EpochHashMap {
+    _Atomic(Table*) table;
+    _Atomic int size;
+    pthread_mutex_t writeLock;
+    Retired *retired;           // Oldest first, only touched under writeLock
+    Retired *retiredTail;
+} EpochHashMap;
+
+// ---------------------------------------------------------------------------
+// Epoch-based reclamation (one domain for the whole process)
+// ---------------------------------------------------------------------------
+
+// Each reader owns one slot on its own cache line; 0 means "not reading"
+typedef struct ReaderSlot {
+    _Atomic uint64_t epoch;
+} __attribute__((aligned(CACHE_LINE_SIZE))) ReaderSlot;
+
+static ReaderSlot readerSlots[MAX_READERS];
+static _Atomic uint64_t globalEpoch = 1;
+static _Thread_local int readerSlot = -1;
+
+// Slots are handed back when their thread exits, so MAX_READERS bounds the
+// threads reading at once, not the threads that have ever read. Slots at or
+// above the high-water mark have never been used; free slots below it hold
+// epoch 0, so scanning them never holds back reclamation.
+static pthread_mutex_t slotLock = PTHREAD_MUTEX_INITIALIZER;
+static int freeSlots[MAX_READERS];
+static int numFreeSlots = 0;
+static _Atomic int slotHighWater = 0;
+static pthread_key_t slotKey;
+static pthread_once_t slotKeyOnce = PTHREAD_ONCE_INIT;
+
+// Thread-exit destructor: return the slot to the free list
+void releaseReaderSlot(void *value) {
+    int slot = (int)(intptr_t)value - 1;
+    atomic_store_explicit(&readerSlots[slot].epoch, 0, memory_order_release);
+
+    pthread_mutex_lock(&slotLock);
+    freeSlots[numFreeSlots++] = slot;
+    pthread_mutex_unlock(&slotLock);
+}
+
+void createSlotKey() {
+    pthread_key_create(&slotKey, releaseReaderSlot);
+}
+
+// Take a free slot, or a fresh one above the high-water mark
+int acquireReaderSlot() {
+    pthread_once(&slotKeyOnce, createSlotKey);
+
+    pthread_mutex_lock(&slotLock);
+    int slot;
+    if (numFreeSlots > 0) {
+        slot = freeSlots[--numFreeSlots];
+    } else {
+        slot = atomic_load_explicit(&slotHighWater, memory_order_relaxed);
+        if (slot >= MAX_READERS) {
+            pthread_mutex_unlock(&slotLock);
+            fprintf(stderr, "EpochHashMap: more than %d concurrent reader threads\n", MAX_READERS);
+            abort();
+        }
+        atomic_store_explicit(&slotHighWater, slot + 1, memory_order_release);
+    }
+    pthread_mutex_unlock(&slotLock);
+
+    // Stored as slot + 1: destructors only run for non-NULL values
+    pthread_setspecific(slotKey, (void*)(intptr_t)(slot + 1));
+    return slot;
+}
+
+// Announce that this thread is about to read shared entries
+void enterRead() {
+    if (readerSlot < 0)
+        readerSlot = acquireReaderSlot();
+
+    uint64_t epoch = atomic_load_explicit(&globalEpoch, memory_order_relaxed);
+    atomic_store_explicit(&readerSlots[readerSlot].epoch, epoch, memory_order_relaxed);
+
+    // Pairs with the fence in collectRetired(): either the writer sees this slot,
+    // or this reader sees the writer's unlink
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+void exitRead() {
+    atomic_store_explicit(&readerSlots[readerSlot].epoch, 0, memory_order_release);
+}
+
+// Smallest epoch announced by a reader still inside a read section
+uint64_t oldestActiveEpoch() {
+    uint64_t oldest = UINT64_MAX;
+    int numSlots = atomic_load(&slotHighWater);
+
+    for (int i = 0; i < numSlots; i++) {
+        uint64_t epoch = atomic_load_explicit(&readerSlots[i].epoch, memory_order_acquire);
+        if (epoch != 0 && epoch < oldest)
+            oldest = epoch;
+    }
+
+    return oldest;
+}
+
+// ---------------------------------------------------------------------------
+// Hash map
+// ---------------------------------------------------------------------------
+
+// 64x64 -> 128-bit multiply folded back to 64 bits
+static inline uint64_t mulFold(uint64_t a, uint64_t b) {
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+// wyhash-style hash, same as HashMap.c's default
+uint64_t hash(const char *key) {
+    size_t length = strlen(key);
+    uint64_t hashValue = 0xa0761d6478bd642fULL;
+    uint64_t word;
+
+    while (length >= 8) {
+        memcpy(&word, key, 8);
+        hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL);
+        key += 8;
+        length -= 8;
+    }
+
+    word = 0;
+    memcpy(&word, key, length);
+    hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL ^ length);
+    return mulFold(hashValue, 0x8ebc6af09c88c6e3ULL);
+}
+
+// Create a new entry (key may be shared with an entry of a retired table)
+Entry* createEntry(char *key, uint64_t hashValue, int value) {
+    Entry *entry = (Entry*)malloc(sizeof(Entry));
+    entry->key = key;
+    entry->hash = hashValue;
+    atomic_init(&entry->value, value);
+    atomic_init(&entry->next, NULL);
+    return entry;
+}
+
+Table* createTable(int capacity) {
+    Table *table = (Table*)malloc(sizeof(Table));
+    table->capacity = capacity;
+    table->buckets = (_Atomic(Entry*)*)calloc(capacity, sizeof(_Atomic(Entry*)));
+    return table;
+}
+
+// Initialize hash map
+EpochHashMap* createHashMap() {
+    EpochHashMap *map = (EpochHashMap*)malloc(sizeof(EpochHashMap));
+    atomic_init(&map->table, createTable(INITIAL_CAPACITY));
+    atomic_init(&map->size, 0);
+    pthread_mutex_init(&map->writeLock, NULL);
+    map->retired = NULL;
+    map->retiredTail = NULL;
+    return map;
+}
+
+// Free a table's bucket array and nodes; keys are owned by the live table
+void freeTableNodes(Table *table) {
+    for (int i = 0; i < table->capacity; i++) {
+        Entry *entry = atomic_load_explicit(&table->buckets[i], memory_order_relaxed);
+        while (entry != NULL) {
+            Entry *next = atomic_load_explicit(&entry->next, memory_order_relaxed);
+            free(entry);
+            entry = next;
+        }
+    }
+    free(table->buckets);
+    free(table);
+}
+
+// Free everything retired before the oldest epoch any reader still holds
+void collectRetired(EpochHashMap *map) {
+    atomic_thread_fence(memory_order_seq_cst);
+    uint64_t oldest = oldestActiveEpoch();
+
+    while (map->retired != NULL && map->retired->epoch < oldest) {
+        Retired *retired = map->retired;
+        map->retired = retired->next;
+
+        if (retired->kind == RETIRED_ENTRY) {
+            Entry *entry = (Entry*)retired->pointer;
+            free(entry->key);
+            free(entry);
+        } else {
+            freeTableNodes((Table*)retired->pointer);
+        }
+        free(retired);
+    }
+
+    if (map->retired == NULL)
+        map->retiredTail = NULL;
+}
+
+// Hand an unlinked pointer to the reclaimer (caller holds writeLock)
+void retire(EpochHashMap *map, void *pointer, RetiredKind kind) {
+    Retired *retired = (Retired*)malloc(sizeof(Retired));
+    retired->pointer = pointer;
+    retired->kind = kind;
+    retired->next = NULL;
+
+    // Readers announcing the new epoch start after the unlink and cannot reach it
+    retired->epoch = atomic_fetch_add(&globalEpoch, 1);
+
+    if (map->retiredTail != NULL)
+        map->retiredTail->next = retired;
+    else
+        map->retired = retired;
+    map->retiredTail = retired;
+
+    collectRetired(map);
+}
+
+// Find an entry in a table (caller is inside a read section or holds writeLock)
+Entry* findEntry(Table *table, const char *key, uint64_t hashValue) {
+    unsigned int index = hashValue & (table->capacity - 1);
+    Entry *entry = atomic_load_explicit(&table->buckets[index], memory_order_acquire);
+
+    while (entry != NULL) {
+        if (entry->hash == hashValue && strcmp(entry->key, key) == 0)
+            return entry;
+        entry = atomic_load_explicit(&entry->next, memory_order_acquire);
+    }
+
+    return NULL;
+}
+
+// Copy every entry into a table twice the size and publish it in one store.
+// Entries are copied rather than relinked so readers still walking the old
+// chains never follow a next pointer into the new table.
+void resize(EpochHashMap *map, Table *oldTable) {
+    Table *newTable = createTable(oldTable->capacity * 2);
+
+    for (int i = 0; i < oldTable->capacity; i++) {
+        Entry *entry = atomic_load_explicit(&oldTable->buckets[i], memory_order_relaxed);
+        while (entry != NULL) {
+            unsigned int index = entry->hash & (newTable->capacity - 1);
+            Entry *copy = createEntry(entry->key, entry->hash,
+                                      atomic_load_explicit(&entry->value, memory_order_relaxed));
+            atomic_store_explicit(&copy->next, atomic_load_explicit(&newTable->buckets[index], memory_order_relaxed),
+                                  memory_order_relaxed);
+            atomic_store_explicit(&newTable->buckets[index], copy, memory_order_relaxed);
+            entry = atomic_load_explicit(&entry->next, memory_order_relaxed);
+        }
+    }
+
+    atomic_store_explicit(&map->table, newTable, memory_order_release);
+    retire(map, oldTable, RETIRED_TABLE);
+}
+
+// Put a key-value pair into the map
+void put(EpochHashMap *map, const char *key, int value) {
+    uint64_t hashValue = hash(key);
+    pthread_mutex_lock(&map->writeLock);
+
+    Table *table = atomic_load_explicit(&map->table, memory_order_relaxed);
+    Entry *entry = findEntry(table, key, hashValue);
+    if (entry != NULL) {
+        atomic_store_explicit(&entry->value, value, memory_order_release);
+        pthread_mutex_unlock(&map->writeLock);
+        return;
+    }
+
+    int size = atomic_load_explicit(&map->size, memory_order_relaxed);
+    if ((double)size / table->capacity >= LOAD_FACTOR_THRESHOLD) {
+        resize(map, table);
+        table = atomic_load_explicit(&map->table, memory_order_relaxed);
+    }
+
+    // Fully build the entry, then publish it with a release store to the bucket head
+    char *keyCopy = (char*)malloc(strlen(key) + 1);
+    strcpy(keyCopy, key);
+    unsigned int index = hashValue & (table->capacity - 1);
+    Entry *newEntry = createEntry(keyCopy, hashValue, value);
+    atomic_store_explicit(&newEntry->next, atomic_load_explicit(&table->buckets[index], memory_order_relaxed),
+                          memory_order_relaxed);
+    atomic_store_explicit(&table->buckets[index], newEntry, memory_order_release);
+    atomic_store_explicit(&map->size, size + 1, memory_order_relaxed);
+
+    pthread_mutex_unlock(&map->writeLock);
+}
+
+// Get value for a key (lock-free: only acquire loads on shared memory)
+int get(EpochHashMap *map, const char *key, bool *found) {
+    uint64_t hashValue = hash(key);
+    int value = -1;
+
+    enterRead();
+    Table *table = atomic_load_explicit(&map->table, memory_order_acquire);
+    Entry *entry = findEntry(table, key, hashValue);
+    *found = entry != NULL;
+    if (entry != NULL)
+        value = atomic_load_explicit(&entry->value, memory_order_acquire);
+    exitRead();
+
+    return value;
+}
+
+// Check if key exists
+bool containsKey(EpochHashMap *map, const char *key) {
+    uint64_t hashValue = hash(key);
+
+    enterRead();
+    Table *table = atomic_load_explicit(&map->table, memory_order_acquire);
+    bool found = findEntry(table, key, hashValue) != NULL;
+    exitRead();
+
+    return found;
+}
+
+// Remove a key-value pair
+bool removeKey(EpochHashMap *map, const char *key) {
+    uint64_t hashValue = hash(key);
+    pthread_mutex_lock(&map->writeLock);
+
+    Table *table = atomic_load_explicit(&map->table, memory_order_relaxed);
+    _Atomic(Entry*) *link = &table->buckets[hashValue & (table->capacity - 1)];
+    Entry *entry = atomic_load_explicit(link, memory_order_relaxed);
+
+    while (entry != NULL) {
+        Entry *next = atomic_load_explicit(&entry->next, memory_order_relaxed);
+        if (entry->hash == hashValue && strcmp(entry->key, key) == 0) {
+            // Readers already on this entry can still follow its next pointer
+            atomic_store_explicit(link, next, memory_order_release);
+            atomic_fetch_sub_explicit(&map->size, 1, memory_order_relaxed);
+            retire(map, entry, RETIRED_ENTRY);
+            pthread_mutex_unlock(&map->writeLock);
+            return true;
+        }
+        link = &entry->next;
+        entry = next;
+    }
+
+    pthread_mutex_unlock(&map->writeLock);
+    return false;
+}
+
+// Get size of map
+int getSize(EpochHashMap *map) {
+    return atomic_load_explicit(&map->size, memory_order_relaxed);
+}
+
+// Check if map is empty
+bool isEmpty(EpochHashMap *map) {
+    return getSize(map) == 0;
+}
+
+// Free the hash map (no other thread may be using it)
+void freeHashMap(EpochHashMap *map) {
+    // Retired tables share keys with the live table, so drop them first
+    while (map->retired != NULL) {
+        Retired *retired = map->retired;
+        map->retired = retired->next;
+        if (retired->kind == RETIRED_ENTRY) {
+            Entry *entry = (Entry*)retired->pointer;
+            free(entry->key);
+            free(entry);
+        } else {
+            freeTableNodes((Table*)retired->pointer);
+        }
+        free(retired);
+    }
+
+    Table *table = atomic_load(&map->table);
+    for (int i = 0; i < table->capacity; i++) {
+        Entry *entry = atomic_load_explicit(&table->buckets[i], memory_order_relaxed);
+        while (entry != NULL) {
+            free(entry->key);
+            entry = atomic_load_explicit(&entry->next, memory_order_relaxed);
+        }
+    }
+    freeTableNodes(table);
+
+    pthread_mutex_destroy(&map->writeLock);
+    free(map);
+}
+
+// ---------------------------------------------------------------------------
+// Reader scaling benchmark
+// ---------------------------------------------------------------------------
+
+#define KEY_SPACE 100000
+
+typedef struct Worker {
+    pthread_t thread;
+    EpochHashMap *map;
+    char **keys;
+    int operations;
+    uint64_t rng;
+    long hits;
+} Worker;
+
+// xorshift64: cheap per-thread random numbers with no shared state
+static inline uint64_t nextRandom(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+void* runReader(void *arg) {
+    Worker *worker = (Worker*)arg;
+
+    for (int i = 0; i < worker->operations; i++) {
+        uint64_t r = nextRandom(&worker->rng);
+        worker->hits += containsKey(worker->map, worker->keys[r % KEY_SPACE]);
+    }
+
+    return NULL;
+}
+
+// Lookups per second for numThreads readers while one writer keeps updating
+double measureReaders(EpochHashMap *map, char **keys, int numThreads, int operationsPerThread) {
+    Worker *workers = (Worker*)malloc(numThreads * sizeof(Worker));
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int t = 0; t < numThreads; t++) {
+        workers[t].map = map;
+        workers[t].keys = keys;
+        workers[t].operations = operationsPerThread;
+        workers[t].rng = 0x9e3779b97f4a7c15ULL * (t + 1);
+        workers[t].hits = 0;
+        pthread_create(&workers[t].thread, NULL, runReader, &workers[t]);
+    }
+
+    // A rare writer: the 1% that is not get()/containsKey()
+    for (int i = 0; i < operationsPerThread / 100; i++) {
+        removeKey(map, keys[i % KEY_SPACE]);
+        put(map, keys[i % KEY_SPACE], i);
+    }
+
+    for (int t = 0; t < numThreads; t++)
+        pthread_join(workers[t].thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    free(workers);
+    return (double)numThreads * operationsPerThread / seconds / 1e6;
+}
+
+// Example usage
+int main() {
+    EpochHashMap *map = createHashMap();
+
+    // Insert key-value pairs
+    printf("Inserting elements...\n");
+    put(map, "apple", 100);
+    put(map, "banana", 200);
+    put(map, "orange", 300);
+    put(map, "grape", 400);
+    put(map, "mango", 500);
+    printf("Size: %d\n", getSize(map));
+
+    // Get values
+    printf("\nGetting values:\n");
+    bool found;
+    int value = get(map, "banana", &found);
+    printf("banana: %s (value: %d)\n", found ? "found" : "not found", value);
+
+    value = get(map, "cherry", &found);
+    printf("cherry: %s\n", found ? "found" : "not found");
+
+    // Update value
+    printf("\nUpdating 'apple' to 150...\n");
+    put(map, "apple", 150);
+    value = get(map, "apple", &found);
+    printf("apple: %d\n", value);
+
+    // Remove a key
+    printf("\nRemoving 'banana'...\n");
+    removeKey(map, "banana");
+    printf("Size after removal: %d\n", getSize(map));
+    printf("Contains key 'banana': %s\n", containsKey(map, "banana") ? "yes" : "no");
+
+    freeHashMap(map);
+
+    // Reader scaling with a concurrent writer (removals and resizes are reclaimed by epoch)
+    char **keys = (char**)malloc(KEY_SPACE * sizeof(char*));
+    for (int i = 0; i < KEY_SPACE; i++) {
+        keys[i] = (char*)malloc(20);
+        sprintf(keys[i], "key%d", i);
+    }
+
+    map = createHashMap();
+    for (int i = 0; i < KEY_SPACE; i++)
+        put(map, keys[i], i);
+
+    // Far more short-lived readers than MAX_READERS: exiting threads give their slots back
+    Worker churn;
+    churn.map = map;
+    churn.keys = keys;
+    churn.operations = 100;
+    churn.rng = 0x9e3779b97f4a7c15ULL;
+    churn.hits = 0;
+    for (int i = 0; i < 4 * MAX_READERS; i++) {
+        pthread_create(&churn.thread, NULL, runReader, &churn);
+        pthread_join(churn.thread, NULL);
+    }
+    printf("\n%d short-lived reader threads done, %d slots ever used\n",
+           4 * MAX_READERS, atomic_load(&slotHighWater));
+
+    printf("\nReader throughput (Mops/s):\n");
+    int threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+    for (int t = 0; t < 7; t++)
+        printf("%2d readers: %.2f\n", threadCounts[t], measureReaders(map, keys, threadCounts[t], 200000));
+
+    freeHashMap(map);
+    for (int i = 0; i < KEY_SPACE; i++)
+        free(keys[i]);
+    free(keys);
+
+    return 0;
+}
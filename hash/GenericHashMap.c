@@ -0,0 +1,373 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#define GENERIC_INITIAL_CAPACITY 16
+
+// DEFINE_HASHMAP(name, K, V, hashfn, eqfn) generates a map type `name` from K to V.
+// Keys and values are stored by value in one flat slot array (linear probing),
+// so there is no allocation per key. hashfn(K) -> uint64_t and eqfn(K, K) -> bool
+// are called directly and get inlined into every generated function.
+//
+// Generated functions:
+//   name *name##_create(void)
+//   void  name##_put(name *map, K key, V value)
+//   bool  name##_get(name *map, K key, V *value)
+//   bool  name##_contains(name *map, K key)
+//   bool  name##_remove(name *map, K key)
+//   int   name##_size(name *map)
+//   void  name##_free(name *map)
+#define DEFINE_HASHMAP(name, K, V, hashfn, eqfn)                                \
+                                                                                \
+typedef struct name##_Slot {                                                    \
+    K key;                                                                      \
+    V value;                                                                    \
+} name##_Slot;                                                                  \
+                                                                                \
+typedef struct name {                                                           \
+    name##_Slot *slots;                                                         \
+    bool *occupied;                                                             \
+    int capacity;                                                               \
+    int size;                                                                   \
+} name;                                                                         \
+                                                                                \
+static inline name* name##_createWithCapacity(int capacity) {                   \
+    name *map = (name*)malloc(sizeof(name));                                    \
+    map->capacity = capacity;                                                   \
+    map->size = 0;                                                              \
+    map->slots = (name##_Slot*)malloc(capacity * sizeof(name##_Slot));         \
+    map->occupied = (bool*)calloc(capacity, sizeof(bool));                      \
+    return map;                                                                 \
+}                                                                               \
+                                                                                \
+static inline name* name##_create(void) {                                       \
+    return name##_createWithCapacity(GENERIC_INITIAL_CAPACITY);                 \
+}                                                                               \
+                                                                                \
+/* Slot holding key, or the empty slot where it would go */                    \
+static inline int name##_findSlot(name *map, K key) {                           \
+    int mask = map->capacity - 1;                                               \
+    int index = (int)(hashfn(key) & mask);                                      \
+                                                                                \
+    while (map->occupied[index] && !eqfn(map->slots[index].key, key))          \
+        index = (index + 1) & mask;                                             \
+                                                                                \
+    return index;                                                               \
+}                                                                               \
+                                                                                \
+static inline void name##_resize(name *map) {                                   \
+    name##_Slot *oldSlots = map->slots;                                         \
+    bool *oldOccupied = map->occupied;                                          \
+    int oldCapacity = map->capacity;                                            \
+                                                                                \
+    map->capacity *= 2;                                                         \
+    map->slots = (name##_Slot*)malloc(map->capacity * sizeof(name##_Slot));    \
+    map->occupied = (bool*)calloc(map->capacity, sizeof(bool));                 \
+                                                                                \
+    for (int i = 0; i < oldCapacity; i++) {                                     \
+        if (oldOccupied[i]) {                                                   \
+            int index = name##_findSlot(map, oldSlots[i].key);                  \
+            map->slots[index] = oldSlots[i];                                    \
+            map->occupied[index] = true;                                        \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    free(oldSlots);                                                             \
+    free(oldOccupied);                                                          \
+}                                                                               \
+                                                                                \
+static inline void name##_put(name *map, K key, V value) {                      \
+    int index = name##_findSlot(map, key);                                      \
+    if (!map->occupied[index]) {                                                \
+        /* Keep at least 1/4 of the slots free so probe runs stay short; */     \
+        /* only a real insert can grow the table */                             \
+        if ((map->size + 1) * 4 > map->capacity * 3) {                          \
+            name##_resize(map);                                                 \
+            index = name##_findSlot(map, key);                                  \
+        }                                                                       \
+        map->occupied[index] = true;                                            \
+        map->slots[index].key = key;                                            \
+        map->size++;                                                            \
+    }                                                                           \
+    map->slots[index].value = value;                                            \
+}                                                                               \
+                                                                                \
+static inline bool name##_get(name *map, K key, V *value) {                     \
+    int index = name##_findSlot(map, key);                                      \
+    if (!map->occupied[index])                                                  \
+        return false;                                                           \
+    *value = map->slots[index].value;                                           \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline bool name##_contains(name *map, K key) {                          \
+    return map->occupied[name##_findSlot(map, key)];                            \
+}                                                                               \
+                                                                                \
+/* Backward-shift deletion: pull later entries of the run into the hole, */    \
+/* so no tombstones are needed */                                               \
+static inline bool name##_remove(name *map, K key) {                            \
+    int mask = map->capacity - 1;                                               \
+    int hole = name##_findSlot(map, key);                                       \
+    if (!map->occupied[hole])                                                   \
+        return false;                                                           \
+                                                                                \
+    int index = hole;                                                           \
+    for (;;) {                                                                  \
+        index = (index + 1) & mask;                                             \
+        if (!map->occupied[index])                                              \
+            break;                                                              \
+                                                                                \
+        /* An entry may move back only if its home is not inside (hole, index] */ \
+        int home = (int)(hashfn(map->slots[index].key) & mask);                 \
+        bool homeInRange = hole <= index ? (hole < home && home <= index)       \
+                                         : (hole < home || home <= index);      \
+        if (!homeInRange) {                                                     \
+            map->slots[hole] = map->slots[index];                               \
+            hole = index;                                                       \
+        }                                                                       \
+    }                                                                           \
+                                                                                \
+    map->occupied[hole] = false;                                                \
+    map->size--;                                                                \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline int name##_size(name *map) {                                      \
+    return map->size;                                                           \
+}                                                                               \
+                                                                                \
+static inline void name##_free(name *map) {                                     \
+    free(map->slots);                                                           \
+    free(map->occupied);                                                        \
+    free(map);                                                                  \
+}
+
+// ---------------------------------------------------------------------------
+// Hash and equality functions for common key types
+// ---------------------------------------------------------------------------
+
+// Finalizer from MurmurHash3: full avalanche for integer keys
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static inline uint64_t hashInt(int key) {
+    return mix64((uint64_t)(uint32_t)key);
+}
+
+static inline bool intEquals(int a, int b) {
+    return a == b;
+}
+
+typedef struct Point {
+    int x;
+    int y;
+} Point;
+
+// Both coordinates packed into one 64-bit word: no signed overflow, and
+// distinct points never share the value being mixed
+static inline uint64_t hashPoint(Point p) {
+    return mix64(((uint64_t)(uint32_t)p.x << 32) | (uint32_t)p.y);
+}
+
+static inline bool pointEquals(Point a, Point b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+// Borrowed C strings, to compare against formatting ids into string keys
+static inline uint64_t hashString(const char *key) {
+    uint64_t hashValue = 14695981039346656037ULL;
+    int c;
+
+    while ((c = (unsigned char)*key++)) {
+        hashValue ^= (uint64_t)c;
+        hashValue *= 1099511628211ULL;
+    }
+
+    return hashValue;
+}
+
+static inline bool stringEquals(const char *a, const char *b) {
+    return strcmp(a, b) == 0;
+}
+
+typedef struct Stats {
+    long count;
+    double total;
+} Stats;
+
+DEFINE_HASHMAP(IntMap, int, int, hashInt, intEquals)
+DEFINE_HASHMAP(PointMap, Point, Stats, hashPoint, pointEquals)
+DEFINE_HASHMAP(StringMap, const char*, int, hashString, stringEquals)
+
+double elapsedNs(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+// Integer ids: specialized IntMap vs the sprintf/atoi round-trip through string keys
+void benchmarkIntegerKeys(int n) {
+    IntMap *ints = IntMap_create();
+    StringMap *strings = StringMap_create();
+    char **keys = (char**)malloc(n * sizeof(char*));
+    struct timespec start, end;
+    long sum = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++)
+        IntMap_put(ints, i * 7, i);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double intPut = elapsedNs(start, end) / n;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) {
+        keys[i] = (char*)malloc(16);
+        sprintf(keys[i], "%d", i * 7);
+        StringMap_put(strings, keys[i], i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double stringPut = elapsedNs(start, end) / n;
+
+    int value;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) {
+        if (IntMap_get(ints, i * 7, &value))
+            sum += value;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double intGet = elapsedNs(start, end) / n;
+
+    char key[16];
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) {
+        sprintf(key, "%d", i * 7);
+        if (StringMap_get(strings, key, &value))
+            sum += value;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double stringGet = elapsedNs(start, end) / n;
+
+    printf("%d integer keys (ns/op):\n", n);
+    printf("IntMap:              put %.1f  get %.1f\n", intPut, intGet);
+    printf("sprintf + StringMap: put %.1f  get %.1f  (checksum %ld)\n", stringPut, stringGet, sum);
+
+    IntMap_free(ints);
+    StringMap_free(strings);
+    for (int i = 0; i < n; i++)
+        free(keys[i]);
+    free(keys);
+}
+
+// Random puts, removes and gets on a small key range (so keys keep colliding,
+// being removed and coming back), checked against a plain array after every
+// operation; true if the map agreed every time
+bool checkAgainstReference(int operations, int keyRange) {
+    IntMap *map = IntMap_create();
+    int *expected = (int*)malloc(keyRange * sizeof(int));
+    bool *present = (bool*)calloc(keyRange, sizeof(bool));
+    int expectedSize = 0;
+    bool agreed = true;
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+
+    for (int i = 0; i < operations && agreed; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        int key = (int)(rng % keyRange) - keyRange / 2;
+        int slot = key + keyRange / 2;
+        int value;
+
+        switch ((rng >> 32) % 3) {
+            case 0:
+                IntMap_put(map, key, i);
+                expectedSize += !present[slot];
+                present[slot] = true;
+                expected[slot] = i;
+                break;
+            case 1:
+                agreed = IntMap_remove(map, key) == present[slot];
+                expectedSize -= present[slot];
+                present[slot] = false;
+                break;
+            default:
+                agreed = IntMap_get(map, key, &value) == present[slot] &&
+                         (!present[slot] || value == expected[slot]);
+                break;
+        }
+
+        agreed = agreed && IntMap_size(map) == expectedSize;
+    }
+
+    IntMap_free(map);
+    free(expected);
+    free(present);
+    return agreed;
+}
+
+// Example usage
+int main() {
+    // Integer ids to integer values, no string formatting involved
+    printf("IntMap:\n");
+    IntMap *ids = IntMap_create();
+    for (int i = 0; i < 20; i++)
+        IntMap_put(ids, i * 100, i);
+
+    int value = -1;
+    bool found = IntMap_get(ids, 500, &value);
+    printf("get(500): %s (value: %d)\n", found ? "found" : "not found", value);
+    printf("contains(550): %s\n", IntMap_contains(ids, 550) ? "yes" : "no");
+
+    printf("Removing 500...\n");
+    IntMap_remove(ids, 500);
+    printf("contains(500): %s, size: %d\n", IntMap_contains(ids, 500) ? "yes" : "no", IntMap_size(ids));
+    IntMap_free(ids);
+
+    // Struct keys and struct values stored inline
+    printf("\nPointMap:\n");
+    PointMap *grid = PointMap_create();
+    Point samples[] = {{1, 2}, {3, 4}, {1, 2}, {5, 6}, {3, 4}, {1, 2}};
+    double readings[] = {10.0, 20.0, 30.0, 40.0, 50.0, 60.0};
+
+    for (int i = 0; i < 6; i++) {
+        Stats stats = {0, 0.0};
+        PointMap_get(grid, samples[i], &stats);
+        stats.count++;
+        stats.total += readings[i];
+        PointMap_put(grid, samples[i], stats);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        Point p = {2 * i + 1, 2 * i + 2};
+        Stats stats;
+        if (PointMap_get(grid, p, &stats))
+            printf("(%d, %d): count %ld, mean %.1f\n", p.x, p.y, stats.count, stats.total / stats.count);
+    }
+    PointMap_free(grid);
+
+    // Updating existing keys must never grow the table
+    printf("\nUpdates:\n");
+    IntMap *updates = IntMap_create();
+    for (int i = 0; i < 12; i++)
+        IntMap_put(updates, i, i);
+    int capacityBefore = updates->capacity;
+    for (int round = 0; round < 100; round++)
+        IntMap_put(updates, round % 12, round);
+    printf("12 keys, 100 updates: capacity %d -> %d\n", capacityBefore, updates->capacity);
+    IntMap_free(updates);
+
+    printf("\nRandomized check against a reference array (1M operations): %s\n",
+           checkAgainstReference(1000000, 4096) ? "agreed" : "MISMATCH");
+
+    printf("\n");
+    benchmarkIntegerKeys(1 << 20);
+
+    return 0;
+}
@@ -2,157 +2,798 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/random.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #define INITIAL_CAPACITY 16
+#define MAX_CAPACITY (1 << 30)  // Largest power of two an int capacity can hold
 #define LOAD_FACTOR_THRESHOLD 0.75
+#define SHRINK_LOAD_FACTOR 0.2     // Well below the growth threshold, so sizes near a boundary don't thrash
+#define REHASH_BUCKETS_PER_OP 4
+#define SLAB_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT 16
+#define ARENA_SIZE_CLASSES 32   // Freelists for blocks of 16, 32, ..., 512 bytes
+#define INLINE_KEY_SIZE 24      // Keys shorter than this live inside the entry
+#define BATCH_CHUNK 64          // Keys whose memory loads are kept in flight together
+#define BLOOM_BLOCK_WORDS 8     // 8 x 64 bits: one cache line per block
+#define BLOOM_DEFAULT_BITS_PER_KEY 10
 
 typedef struct Entry {
-    char *key;
-    int value;
+    uint64_t hash;  // Full hash of key, so resizes never re-read the key bytes
     struct Entry *next;
+    int value;
+    int keyLength;
+    union {
+        char inlineKey[INLINE_KEY_SIZE];  // keyLength < INLINE_KEY_SIZE
+        char *heapKey;                    // Longer keys spill to a separate buffer
+    };
 } Entry;
 
+// Slabs are bump-allocated and only released all together
+typedef struct Slab {
+    struct Slab *next;
+    size_t size;
+    char data[];
+} Slab;
+
+typedef struct FreeBlock {
+    struct FreeBlock *next;
+} FreeBlock;
+
+typedef struct Arena {
+    Slab *slabs;
+    char *cursor;
+    size_t remaining;
+    FreeBlock *freeLists[ARENA_SIZE_CLASSES];  // Blocks returned by removeKey()
+} Arena;
+
+// Blocked Bloom filter: each key sets one bit in every word of a single
+// cache-line block, so a test is one cache miss and a vector compare
+typedef struct BloomFilter {
+    uint64_t *blocks;       // numBlocks * BLOOM_BLOCK_WORDS words, 64-byte aligned
+    uint64_t numBlocks;
+    int bitsPerKey;
+    int staleKeys;          // Removed keys whose bits are still set
+} BloomFilter;
+
+typedef uint64_t (*HashFunction)(const char *key, uint64_t seed);
+
+typedef enum HashKind {
+    HASH_DJB2,
+    HASH_FNV1A,
+    HASH_WYMIX,         // wyhash-style 8-bytes-at-a-time multiply-fold mixer
+    HASH_WYMIX_SEEDED,  // Same mixer with a per-map random seed (hash-flood resistant)
+    HASH_KIND_COUNT
+} HashKind;
+
 typedef struct HashMap {
     Entry **buckets;
     int capacity;
     int size;
+    Entry **oldBuckets;     // Table being drained while a rehash is in progress
+    int oldCapacity;
+    int rehashIndex;        // Next old bucket to migrate
+    bool incrementalRehash; // false: resize() migrates everything at once
+    bool autoShrink;        // Halve the table when removeKey() leaves it sparse
+    int minCapacity;        // Automatic shrinking never goes below this; raised by reserve()
+    Arena *arena;           // NULL: entries and keys come from malloc
+    BloomFilter *bloom;     // NULL: every lookup walks its chain
+    BloomFilter *pendingBloom;  // Sized for the new table and fed by rehashStep(); replaces bloom once the drain ends
+    HashKind hashKind;
+    HashFunction hashFunction;
+    uint64_t seed;
 } HashMap;
 
+// In-place cursor over a map; yields borrowed keys, invalidated by put/removeKey
+typedef struct HashMapIterator {
+    HashMap *map;
+    int bucket;     // Next bucket to visit
+    Entry *entry;   // Next entry in the current chain
+} HashMapIterator;
+
+typedef void (*ScanVisitor)(const char *key, int value, void *context);
+
+// On-disk snapshot: header, open-addressed slot array, then the key bytes.
+// Keys are referenced by offset, so the image works wherever it is mapped.
+#define SNAPSHOT_MAGIC "HMSNAP01"
+#define SNAPSHOT_EMPTY_SLOT UINT32_MAX
+
+typedef struct SnapshotHeader {
+    char magic[8];
+    uint32_t hashKind;
+    uint32_t reserved;
+    uint64_t seed;
+    uint64_t numSlots;      // Power of two, at most half full
+    uint64_t numEntries;
+    uint64_t slotsOffset;
+    uint64_t keysOffset;
+    uint64_t fileSize;
+} SnapshotHeader;
+
+typedef struct SnapshotSlot {
+    uint64_t hash;
+    uint64_t keyOffset;     // Relative to keysOffset
+    uint32_t keyLength;     // SNAPSHOT_EMPTY_SLOT marks an unused slot
+    int32_t value;
+} SnapshotSlot;
+
+// Read-only map over a fixed key set, indexed by a minimal perfect hash
+// (PTHash-style): key -> bucket -> pilot -> exactly one slot in [0, numKeys).
+// Pilots search a table 1% larger than numKeys (a fully minimal search would
+// need ~n tries for the last keys); the few keys that land past numKeys are
+// remapped onto the slots left free below it.
+#define FROZEN_KEYS_PER_BUCKET 5
+#define FROZEN_LOAD_FACTOR 0.99
+#define FROZEN_MAX_PILOT 65535
+#define FROZEN_MAX_ATTEMPTS 16
+
+typedef struct FrozenHashMap {
+    uint64_t seed;
+    int numKeys;
+    int numSlots;               // Search range of the pilots, slightly above numKeys
+    int numBuckets;
+    int denseBuckets;           // The first 30% of buckets receive 60% of the keys
+    uint16_t *pilots;           // One per bucket: the bulk of the index
+    uint32_t *remap;            // Slot in [0, numKeys) for positions in [numKeys, numSlots)
+    uint16_t *fingerprints;     // Optional, one per slot: rejects misses without strcmp
+    int *values;
+    uint32_t *keyOffsets;
+    char *keys;
+} FrozenHashMap;
+
+// Read-only map served straight from a mapped snapshot file
+typedef struct MappedHashMap {
+    const char *base;
+    size_t length;
+    const SnapshotHeader *header;
+    const SnapshotSlot *slots;
+    const char *keys;
+    uint64_t keysLength;
+    HashFunction hashFunction;
+} MappedHashMap;
+
+// Create an empty arena
+Arena* createArena() {
+    Arena *arena = (Arena*)calloc(1, sizeof(Arena));
+    return arena;
+}
+
+// Add a slab with at least size usable bytes and make it the bump target
+void addSlab(Arena *arena, size_t size) {
+    size_t slabSize = size > SLAB_SIZE ? size : SLAB_SIZE;
+    Slab *slab = (Slab*)malloc(sizeof(Slab) + slabSize);
+    slab->size = slabSize;
+    slab->next = arena->slabs;
+    arena->slabs = slab;
+    arena->cursor = slab->data;
+    arena->remaining = slabSize;
+}
+
+// Allocate size bytes, reusing a freed block of the same size class if any
+void* arenaAlloc(Arena *arena, size_t size) {
+    size_t rounded = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    size_t sizeClass = rounded / ARENA_ALIGNMENT - 1;
+    
+    if (sizeClass < ARENA_SIZE_CLASSES && arena->freeLists[sizeClass] != NULL) {
+        FreeBlock *block = arena->freeLists[sizeClass];
+        arena->freeLists[sizeClass] = block->next;
+        return block;
+    }
+    
+    // Oversized blocks get a dedicated slab; the current bump slab stays in use
+    if (sizeClass >= ARENA_SIZE_CLASSES && rounded > arena->remaining) {
+        Slab *slab = (Slab*)malloc(sizeof(Slab) + rounded);
+        slab->size = rounded;
+        if (arena->slabs != NULL) {
+            slab->next = arena->slabs->next;
+            arena->slabs->next = slab;
+        } else {
+            slab->next = NULL;
+            arena->slabs = slab;
+        }
+        return slab->data;
+    }
+    
+    if (rounded > arena->remaining)
+        addSlab(arena, rounded);
+    
+    void *block = arena->cursor;
+    arena->cursor += rounded;
+    arena->remaining -= rounded;
+    return block;
+}
+
+// Return a block to its size-class freelist (oversized blocks wait for reset)
+void arenaFree(Arena *arena, void *block, size_t size) {
+    size_t rounded = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    size_t sizeClass = rounded / ARENA_ALIGNMENT - 1;
+    
+    if (sizeClass < ARENA_SIZE_CLASSES) {
+        FreeBlock *freed = (FreeBlock*)block;
+        freed->next = arena->freeLists[sizeClass];
+        arena->freeLists[sizeClass] = freed;
+    }
+}
+
+// Release every slab at once: O(slabs), independent of the number of entries
+void resetArena(Arena *arena) {
+    Slab *slab = arena->slabs;
+    while (slab != NULL) {
+        Slab *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    memset(arena, 0, sizeof(Arena));
+}
+
+// Check if an entry keeps its key inline
+bool hasInlineKey(Entry *entry) {
+    return entry->keyLength < INLINE_KEY_SIZE;
+}
+
+// Get the key bytes of an entry
+char* entryKey(Entry *entry) {
+    return hasInlineKey(entry) ? entry->inlineKey : entry->heapKey;
+}
+
 // Create a new entry
-Entry* createEntry(const char *key, int value) {
-    Entry *entry = (Entry*)malloc(sizeof(Entry));
-    entry->key = (char*)malloc(strlen(key) + 1);
-    strcpy(entry->key, key);
+Entry* createEntry(HashMap *map, const char *key, uint64_t hashValue, int value) {
+    int keyLength = strlen(key);
+    Entry *entry;
+    
+    if (map->arena != NULL)
+        entry = (Entry*)arenaAlloc(map->arena, sizeof(Entry));
+    else
+        entry = (Entry*)malloc(sizeof(Entry));
+    
+    entry->keyLength = keyLength;
+    if (!hasInlineKey(entry)) {
+        if (map->arena != NULL)
+            entry->heapKey = (char*)arenaAlloc(map->arena, keyLength + 1);
+        else
+            entry->heapKey = (char*)malloc(keyLength + 1);
+    }
+    
+    memcpy(entryKey(entry), key, keyLength + 1);
+    entry->hash = hashValue;
     entry->value = value;
     entry->next = NULL;
     return entry;
 }
 
-// Hash function using djb2 algorithm
-unsigned int hash(const char *key, int capacity) {
-    unsigned long hashValue = 5381;
+// Free an entry and its key
+void freeEntry(HashMap *map, Entry *entry) {
+    if (map->arena != NULL) {
+        if (!hasInlineKey(entry))
+            arenaFree(map->arena, entry->heapKey, entry->keyLength + 1);
+        arenaFree(map->arena, entry, sizeof(Entry));
+    } else {
+        if (!hasInlineKey(entry))
+            free(entry->heapKey);
+        free(entry);
+    }
+}
+
+// Hash function using djb2 algorithm (full 64-bit value)
+uint64_t djb2Hash(const char *key, uint64_t seed) {
+    uint64_t hashValue = 5381 ^ seed;
     int c;
     
     while ((c = *key++))
         hashValue = ((hashValue << 5) + hashValue) + c;
     
-    return hashValue % capacity;
+    return hashValue;
 }
 
-// Initialize hash map
-HashMap* createHashMap() {
+// Hash function using 64-bit FNV-1a
+uint64_t fnv1aHash(const char *key, uint64_t seed) {
+    uint64_t hashValue = 14695981039346656037ULL ^ seed;
+    int c;
+    
+    while ((c = (unsigned char)*key++)) {
+        hashValue ^= (uint64_t)c;
+        hashValue *= 1099511628211ULL;
+    }
+    
+    return hashValue;
+}
+
+// 64x64 -> 128-bit multiply folded back to 64 bits
+static inline uint64_t mulFold(uint64_t a, uint64_t b) {
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+// wyhash-style hash: consumes 8 bytes per multiply instead of 1 byte per step
+uint64_t wymixHash(const char *key, uint64_t seed) {
+    size_t length = strlen(key);
+    uint64_t hashValue = seed ^ 0xa0761d6478bd642fULL;
+    uint64_t word;
+    
+    while (length >= 8) {
+        memcpy(&word, key, 8);
+        hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL);
+        key += 8;
+        length -= 8;
+    }
+    
+    word = 0;
+    memcpy(&word, key, length);
+    hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL ^ length);
+    return mulFold(hashValue, 0x8ebc6af09c88c6e3ULL);
+}
+
+const char *hashNames[HASH_KIND_COUNT] = {"djb2", "fnv1a", "wymix", "wymix-seeded"};
+HashFunction hashFunctions[HASH_KIND_COUNT] = {djb2Hash, fnv1aHash, wymixHash, wymixHash};
+
+// Hash a key with the map's selected function
+uint64_t hashKey(HashMap *map, const char *key) {
+    return map->hashFunction(key, map->seed);
+}
+
+// Reduce a full hash to a bucket index (capacity is always a power of two)
+unsigned int bucketIndex(uint64_t hashValue, int capacity) {
+    return hashValue & (capacity - 1);
+}
+
+// Cheap hash comparison first; key bytes are only read on a full-hash match
+bool keyMatches(Entry *entry, const char *key, uint64_t hashValue) {
+    return entry->hash == hashValue && strcmp(entryKey(entry), key) == 0;
+}
+
+// 64 bits from the kernel's CSPRNG, falling back to /dev/urandom. Time and
+// addresses are guessable, so they are only mixed in if both sources fail.
+uint64_t randomSeed(void *salt) {
+    uint64_t seed;
+    if (getrandom(&seed, sizeof(seed), 0) == (ssize_t)sizeof(seed))
+        return seed;
+    
+    int fd = open("/dev/urandom", O_RDONLY);
+    if (fd >= 0) {
+        ssize_t bytesRead = read(fd, &seed, sizeof(seed));
+        close(fd);
+        if (bytesRead == (ssize_t)sizeof(seed))
+            return seed;
+    }
+    
+    return mulFold((uint64_t)time(NULL) ^ (uint64_t)(uintptr_t)salt, 0x9e3779b97f4a7c15ULL);
+}
+
+// Initialize hash map using the given hash function
+HashMap* createHashMapWithHash(HashKind hashKind) {
     HashMap *map = (HashMap*)malloc(sizeof(HashMap));
     map->capacity = INITIAL_CAPACITY;
     map->size = 0;
     map->buckets = (Entry**)calloc(map->capacity, sizeof(Entry*));
+    map->oldBuckets = NULL;
+    map->oldCapacity = 0;
+    map->rehashIndex = 0;
+    map->incrementalRehash = true;
+    map->autoShrink = true;
+    map->minCapacity = INITIAL_CAPACITY;
+    map->arena = NULL;
+    map->bloom = NULL;
+    map->pendingBloom = NULL;
+    map->hashKind = hashKind;
+    map->hashFunction = hashFunctions[hashKind];
+    map->seed = 0;
+    
+    // Per-map secret seed so colliding key sets cannot be precomputed or guessed
+    if (hashKind == HASH_WYMIX_SEEDED)
+        map->seed = randomSeed(map);
+    
+    return map;
+}
+
+// Initialize hash map
+HashMap* createHashMap() {
+    return createHashMapWithHash(HASH_WYMIX);
+}
+
+// Initialize hash map whose entries and keys are carved out of slabs
+HashMap* createArenaHashMap() {
+    HashMap *map = createHashMap();
+    map->arena = createArena();
     return map;
 }
 
+// Check if a rehash is still draining the old table
+bool isRehashing(HashMap *map) {
+    return map->oldBuckets != NULL;
+}
+
 // Get load factor
 double getLoadFactor(HashMap *map) {
     return (double)map->size / map->capacity;
 }
 
-// Resize and rehash the map
-void resize(HashMap *map) {
-    int oldCapacity = map->capacity;
-    Entry **oldBuckets = map->buckets;
+// Bit positions for one key: word i of the block gets bit (x * salt[i]) >> 26
+static inline void bloomMask(uint32_t x, uint64_t mask[BLOOM_BLOCK_WORDS]) {
+    static const uint32_t salts[BLOOM_BLOCK_WORDS] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+    };
+    for (int i = 0; i < BLOOM_BLOCK_WORDS; i++)
+        mask[i] = 1ULL << ((uint32_t)(x * salts[i]) >> 26);
+}
+
+// Block for a hash: the mixed high half picks the block, the low half the bits.
+// Remixing keeps the choice independent of the bucket index (the low hash bits).
+static inline uint64_t* bloomBlock(BloomFilter *bloom, uint64_t hashValue, uint32_t *bits) {
+    uint64_t mixed = mulFold(hashValue, 0x9e3779b97f4a7c15ULL);
+    *bits = (uint32_t)mixed;
+    return bloom->blocks + ((mixed >> 32) * bloom->numBlocks >> 32) * BLOOM_BLOCK_WORDS;
+}
+
+void bloomAdd(BloomFilter *bloom, uint64_t hashValue) {
+    uint32_t bits;
+    uint64_t *block = bloomBlock(bloom, hashValue, &bits);
+    uint64_t mask[BLOOM_BLOCK_WORDS];
+    bloomMask(bits, mask);
     
-    map->capacity *= 2;
-    map->buckets = (Entry**)calloc(map->capacity, sizeof(Entry*));
-    map->size = 0;
+    for (int i = 0; i < BLOOM_BLOCK_WORDS; i++)
+        block[i] |= mask[i];
+}
+
+// false: the key is definitely absent. true: it may be present.
+static inline bool bloomMayContain(BloomFilter *bloom, uint64_t hashValue) {
+    uint32_t bits;
+    uint64_t *block = bloomBlock(bloom, hashValue, &bits);
+    uint64_t mask[BLOOM_BLOCK_WORDS];
+    bloomMask(bits, mask);
     
-    // Rehash all entries
-    for (int i = 0; i < oldCapacity; i++) {
-        Entry *entry = oldBuckets[i];
+#ifdef __SSE2__
+    // Accumulate mask bits missing from the block, two words per register
+    __m128i missing = _mm_setzero_si128();
+    for (int i = 0; i < BLOOM_BLOCK_WORDS; i += 2) {
+        __m128i words = _mm_load_si128((const __m128i*)(block + i));
+        __m128i wanted = _mm_loadu_si128((const __m128i*)(mask + i));
+        missing = _mm_or_si128(missing, _mm_andnot_si128(words, wanted));
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128())) == 0xFFFF;
+#else
+    uint64_t missing = 0;
+    for (int i = 0; i < BLOOM_BLOCK_WORDS; i++)
+        missing |= mask[i] & ~block[i];
+    return missing == 0;
+#endif
+}
+
+// Empty filter sized for as many keys as a table of capacity buckets holds
+// before it grows
+BloomFilter* createBloomFilter(int bitsPerKey, int capacity) {
+    uint64_t bits = (uint64_t)(capacity * LOAD_FACTOR_THRESHOLD) * bitsPerKey;
+    uint64_t numBlocks = (bits + 64 * BLOOM_BLOCK_WORDS - 1) / (64 * BLOOM_BLOCK_WORDS);
+    size_t bytes = numBlocks * BLOOM_BLOCK_WORDS * sizeof(uint64_t);
+    
+    BloomFilter *bloom = (BloomFilter*)malloc(sizeof(BloomFilter));
+    bloom->blocks = (uint64_t*)aligned_alloc(64, bytes);
+    memset(bloom->blocks, 0, bytes);
+    bloom->numBlocks = numBlocks;
+    bloom->bitsPerKey = bitsPerKey;
+    bloom->staleKeys = 0;
+    return bloom;
+}
+
+void freeBloomFilter(BloomFilter *bloom) {
+    if (bloom != NULL) {
+        free(bloom->blocks);
+        free(bloom);
+    }
+}
+
+// Move up to numBuckets old buckets into the new table
+void rehashStep(HashMap *map, int numBuckets) {
+    // Bound the empty buckets skipped too, so one step never scans the whole table
+    long emptyVisits = (long)numBuckets * 10;
+    
+    while (numBuckets > 0 && map->rehashIndex < map->oldCapacity) {
+        Entry *entry = map->oldBuckets[map->rehashIndex];
+        
+        if (entry == NULL) {
+            map->rehashIndex++;
+            if (--emptyVisits == 0)
+                break;
+            continue;
+        }
+        
         while (entry != NULL) {
             Entry *next = entry->next;
             
             // Reinsert into new buckets
-            unsigned int index = hash(entry->key, map->capacity);
+            unsigned int index = bucketIndex(entry->hash, map->capacity);
             entry->next = map->buckets[index];
             map->buckets[index] = entry;
-            map->size++;
+            
+            if (map->pendingBloom != NULL)
+                bloomAdd(map->pendingBloom, entry->hash);
             
             entry = next;
         }
+        
+        map->oldBuckets[map->rehashIndex++] = NULL;
+        numBuckets--;
     }
     
-    free(oldBuckets);
+    if (map->rehashIndex == map->oldCapacity) {
+        free(map->oldBuckets);
+        map->oldBuckets = NULL;
+        map->oldCapacity = 0;
+        map->rehashIndex = 0;
+        
+        // Every key has now reached the new filter, by migration or by put()
+        if (map->pendingBloom != NULL) {
+            freeBloomFilter(map->bloom);
+            map->bloom = map->pendingBloom;
+            map->pendingBloom = NULL;
+        }
+    }
 }
 
-// Put a key-value pair into the map
-void put(HashMap *map, const char *key, int value) {
-    // Check if resize is needed
-    if (getLoadFactor(map) >= LOAD_FACTOR_THRESHOLD) {
-        resize(map);
+// Drain whatever is left of the old table
+void finishRehash(HashMap *map) {
+    while (isRehashing(map))
+        rehashStep(map, map->oldCapacity);
+}
+
+// Replace the filter with one sized for the current table and re-add every
+// key from both tables. Bloom filters cannot delete, so this is how bits left
+// behind by removed keys are dropped. The result already covers the new
+// table, so a filter still being fed by a rehash is no longer needed.
+void rebuildBloomFilter(HashMap *map) {
+    BloomFilter *bloom = createBloomFilter(map->bloom->bitsPerKey, map->capacity);
+    freeBloomFilter(map->bloom);
+    freeBloomFilter(map->pendingBloom);
+    map->bloom = bloom;
+    map->pendingBloom = NULL;
+    
+    for (int i = 0; i < map->capacity; i++)
+        for (Entry *entry = map->buckets[i]; entry != NULL; entry = entry->next)
+            bloomAdd(bloom, entry->hash);
+    
+    for (int i = map->rehashIndex; i < map->oldCapacity; i++)
+        for (Entry *entry = map->oldBuckets[i]; entry != NULL; entry = entry->next)
+            bloomAdd(bloom, entry->hash);
+}
+
+// Put a Bloom filter in front of the buckets, so most lookups of absent keys
+// return without reading a chain. bitsPerKey trades memory for false positives
+// (10 bits: about 1%); 0 removes the filter.
+void enableBloomFilter(HashMap *map, int bitsPerKey) {
+    freeBloomFilter(map->bloom);
+    freeBloomFilter(map->pendingBloom);
+    map->bloom = NULL;
+    map->pendingBloom = NULL;
+    if (bitsPerKey <= 0)
+        return;
+    
+    map->bloom = createBloomFilter(bitsPerKey, map->capacity);
+    rebuildBloomFilter(map);
+}
+
+// Move the map to a table of newCapacity buckets (a power of two, larger or
+// smaller). The old table stays live and is drained a few buckets per
+// operation, so no single put() or removeKey() pays for rehashing the whole map.
+void resizeTo(HashMap *map, int newCapacity) {
+    // A previous rehash must finish before the table can change size again
+    finishRehash(map);
+    if (newCapacity == map->capacity)
+        return;
+    
+    map->oldBuckets = map->buckets;
+    map->oldCapacity = map->capacity;
+    map->rehashIndex = 0;
+    
+    map->capacity = newCapacity;
+    map->buckets = (Entry**)calloc(map->capacity, sizeof(Entry*));
+    
+    // The current filter keeps answering lookups while the drain feeds a new
+    // one sized for the new table, so a filter adds no O(n) pass to resizing
+    if (map->bloom != NULL)
+        map->pendingBloom = createBloomFilter(map->bloom->bitsPerKey, map->capacity);
+    
+    if (!map->incrementalRehash)
+        finishRehash(map);
+}
+
+// Double the map; at MAX_CAPACITY chains just grow longer instead
+void resize(HashMap *map) {
+    if (map->capacity < MAX_CAPACITY)
+        resizeTo(map, map->capacity * 2);
+}
+
+// Smallest table that holds n keys below the growth threshold, capped at
+// MAX_CAPACITY
+int capacityFor(int n) {
+    int capacity = INITIAL_CAPACITY;
+    while (capacity < MAX_CAPACITY && n >= capacity * LOAD_FACTOR_THRESHOLD)
+        capacity *= 2;
+    return capacity;
+}
+
+// Presize for n keys, so loading them triggers no rehash at all. Requests
+// beyond what MAX_CAPACITY buckets hold reserve MAX_CAPACITY. The table
+// also won't shrink automatically below this size until shrinkToFit().
+void reserve(HashMap *map, int n) {
+    int capacity = capacityFor(n);
+    if (capacity > map->minCapacity)
+        map->minCapacity = capacity;
+    
+    if (capacity > map->capacity) {
+        resizeTo(map, capacity);
+        finishRehash(map);
     }
+}
+
+// Release unused buckets: the smallest table that fits the current keys.
+// Drops any reservation made with reserve().
+void shrinkToFit(HashMap *map) {
+    map->minCapacity = INITIAL_CAPACITY;
+    resizeTo(map, capacityFor(map->size));
+    finishRehash(map);
+}
+
+// Find the entry for a key in whichever table currently holds it
+Entry* findEntry(HashMap *map, const char *key, uint64_t hashValue) {
+    if (map->bloom != NULL && !bloomMayContain(map->bloom, hashValue))
+        return NULL;
     
-    unsigned int index = hash(key, map->capacity);
-    Entry *entry = map->buckets[index];
+    Entry *entry = map->buckets[bucketIndex(hashValue, map->capacity)];
     
-    // Check if key already exists
     while (entry != NULL) {
-        if (strcmp(entry->key, key) == 0) {
-            entry->value = value;
-            return;
-        }
+        if (keyMatches(entry, key, hashValue))
+            return entry;
         entry = entry->next;
     }
     
-    // Insert new entry at the beginning
-    Entry *newEntry = createEntry(key, value);
+    if (isRehashing(map)) {
+        entry = map->oldBuckets[bucketIndex(hashValue, map->oldCapacity)];
+        while (entry != NULL) {
+            if (keyMatches(entry, key, hashValue))
+                return entry;
+            entry = entry->next;
+        }
+    }
+    
+    return NULL;
+}
+
+// Put a key-value pair whose hash is already known
+void putHashed(HashMap *map, const char *key, uint64_t hashValue, int value) {
+    // Check if key already exists
+    Entry *entry = findEntry(map, key, hashValue);
+    if (entry != NULL) {
+        entry->value = value;
+        return;
+    }
+    
+    // Check if resize is needed
+    if (getLoadFactor(map) >= LOAD_FACTOR_THRESHOLD) {
+        resize(map);
+    }
+    
+    // Insert new entry at the beginning (always into the newest table)
+    unsigned int index = bucketIndex(hashValue, map->capacity);
+    Entry *newEntry = createEntry(map, key, hashValue, value);
     newEntry->next = map->buckets[index];
     map->buckets[index] = newEntry;
     map->size++;
+    
+    if (map->bloom != NULL)
+        bloomAdd(map->bloom, hashValue);
+    if (map->pendingBloom != NULL)
+        bloomAdd(map->pendingBloom, hashValue);
+}
+
+// Put a key-value pair into the map
+void put(HashMap *map, const char *key, int value) {
+    if (isRehashing(map))
+        rehashStep(map, REHASH_BUCKETS_PER_OP);
+    
+    putHashed(map, key, hashKey(map, key), value);
 }
 
 // Get value for a key
 int get(HashMap *map, const char *key, bool *found) {
-    unsigned int index = hash(key, map->capacity);
-    Entry *entry = map->buckets[index];
+    if (isRehashing(map))
+        rehashStep(map, REHASH_BUCKETS_PER_OP);
     
-    while (entry != NULL) {
-        if (strcmp(entry->key, key) == 0) {
-            *found = true;
-            return entry->value;
-        }
-        entry = entry->next;
+    Entry *entry = findEntry(map, key, hashKey(map, key));
+    if (entry != NULL) {
+        *found = true;
+        return entry->value;
     }
     
     *found = false;
     return -1;
 }
 
-// Check if key exists
-bool containsKey(HashMap *map, const char *key) {
-    unsigned int index = hash(key, map->capacity);
-    Entry *entry = map->buckets[index];
+// Start loading the bucket slot(s) a hash maps to
+void prefetchBucket(HashMap *map, uint64_t hashValue) {
+    __builtin_prefetch(&map->buckets[bucketIndex(hashValue, map->capacity)]);
+    if (isRehashing(map))
+        __builtin_prefetch(&map->oldBuckets[bucketIndex(hashValue, map->oldCapacity)]);
+}
+
+// Look up n keys at once. Every key is hashed and its bucket prefetched before
+// any chain is walked, so the cache misses of a whole chunk overlap instead of
+// being paid one after another.
+void getBatch(HashMap *map, const char **keys, int n, int *values, bool *found) {
+    uint64_t hashes[BATCH_CHUNK];
     
-    while (entry != NULL) {
-        if (strcmp(entry->key, key) == 0)
-            return true;
-        entry = entry->next;
+    for (int base = 0; base < n; base += BATCH_CHUNK) {
+        int count = n - base < BATCH_CHUNK ? n - base : BATCH_CHUNK;
+        
+        if (isRehashing(map))
+            rehashStep(map, REHASH_BUCKETS_PER_OP);
+        
+        for (int i = 0; i < count; i++) {
+            hashes[i] = hashKey(map, keys[base + i]);
+            prefetchBucket(map, hashes[i]);
+        }
+        
+        // Bucket slots are arriving now; start on the first entry of each chain
+        for (int i = 0; i < count; i++) {
+            Entry *head = map->buckets[bucketIndex(hashes[i], map->capacity)];
+            if (head != NULL)
+                __builtin_prefetch(head);
+        }
+        
+        for (int i = 0; i < count; i++) {
+            Entry *entry = findEntry(map, keys[base + i], hashes[i]);
+            found[base + i] = entry != NULL;
+            values[base + i] = entry != NULL ? entry->value : -1;
+        }
     }
+}
+
+// Insert or update n key-value pairs, prefetching each chunk's buckets first
+void putBatch(HashMap *map, const char **keys, const int *values, int n) {
+    uint64_t hashes[BATCH_CHUNK];
     
-    return false;
+    for (int base = 0; base < n; base += BATCH_CHUNK) {
+        int count = n - base < BATCH_CHUNK ? n - base : BATCH_CHUNK;
+        
+        // Same migration pace as count individual put() calls
+        if (isRehashing(map))
+            rehashStep(map, REHASH_BUCKETS_PER_OP * count);
+        
+        for (int i = 0; i < count; i++) {
+            hashes[i] = hashKey(map, keys[base + i]);
+            prefetchBucket(map, hashes[i]);
+        }
+        
+        for (int i = 0; i < count; i++)
+            putHashed(map, keys[base + i], hashes[i], values[base + i]);
+    }
 }
 
-// Remove a key-value pair
-bool removeKey(HashMap *map, const char *key) {
-    unsigned int index = hash(key, map->capacity);
-    Entry *entry = map->buckets[index];
+// Check if key exists
+bool containsKey(HashMap *map, const char *key) {
+    return findEntry(map, key, hashKey(map, key)) != NULL;
+}
+
+// Unlink and free a key from one bucket chain
+bool removeFromBucket(HashMap *map, Entry **bucket, const char *key, uint64_t hashValue) {
+    Entry *entry = *bucket;
     Entry *prev = NULL;
     
     while (entry != NULL) {
-        if (strcmp(entry->key, key) == 0) {
+        if (keyMatches(entry, key, hashValue)) {
             if (prev == NULL)
-                map->buckets[index] = entry->next;
+                *bucket = entry->next;
             else
                 prev->next = entry->next;
             
-            free(entry->key);
-            free(entry);
+            freeEntry(map, entry);
             map->size--;
             return true;
         }
@@ -163,16 +804,48 @@ bool removeKey(HashMap *map, const char *key) {
     return false;
 }
 
+// Remove a key-value pair
+bool removeKey(HashMap *map, const char *key) {
+    if (isRehashing(map))
+        rehashStep(map, REHASH_BUCKETS_PER_OP);
+    
+    uint64_t hashValue = hashKey(map, key);
+    bool removed = removeFromBucket(map, &map->buckets[bucketIndex(hashValue, map->capacity)], key, hashValue);
+    
+    if (!removed && isRehashing(map))
+        removed = removeFromBucket(map, &map->oldBuckets[bucketIndex(hashValue, map->oldCapacity)], key, hashValue);
+    
+    // Halving leaves the load at 0.4 at most, far from both thresholds, so
+    // alternating puts and removes cannot bounce the table between two sizes
+    if (removed && map->autoShrink && !isRehashing(map) &&
+        map->capacity > map->minCapacity && getLoadFactor(map) < SHRINK_LOAD_FACTOR)
+        resizeTo(map, map->capacity / 2);
+    
+    // Stale bits only raise the false-positive rate; rebuild once they amount
+    // to half of what the filter was sized for (amortized O(1) per removal).
+    // Mid-rehash, the removal is charged to the incoming filter instead: the
+    // current one is about to be replaced anyway.
+    BloomFilter *charged = map->pendingBloom != NULL ? map->pendingBloom : map->bloom;
+    if (removed && charged != NULL &&
+        ++charged->staleKeys > map->capacity * LOAD_FACTOR_THRESHOLD / 2 && !isRehashing(map))
+        rebuildBloomFilter(map);
+    
+    return removed;
+}
+
 // Get all keys
 char** getKeys(HashMap *map, int *numKeys) {
+    // Full scans are O(n) anyway, so settle into a single table first
+    finishRehash(map);
+    
     char **keys = (char**)malloc(map->size * sizeof(char*));
     int index = 0;
     
     for (int i = 0; i < map->capacity; i++) {
         Entry *entry = map->buckets[i];
         while (entry != NULL) {
-            keys[index] = (char*)malloc(strlen(entry->key) + 1);
-            strcpy(keys[index], entry->key);
+            keys[index] = (char*)malloc(entry->keyLength + 1);
+            memcpy(keys[index], entryKey(entry), entry->keyLength + 1);
             index++;
             entry = entry->next;
         }
@@ -184,6 +857,8 @@ char** getKeys(HashMap *map, int *numKeys) {
 
 // Get all values
 int* getValues(HashMap *map, int *numValues) {
+    finishRehash(map);
+    
     int *values = (int*)malloc(map->size * sizeof(int));
     int index = 0;
     
@@ -199,19 +874,473 @@ int* getValues(HashMap *map, int *numValues) {
     return values;
 }
 
+// Start iterating over a map without copying anything
+HashMapIterator iterBegin(HashMap *map) {
+    // A single table keeps the walk simple; iteration is O(n) anyway
+    finishRehash(map);
+    
+    HashMapIterator it = {map, 0, NULL};
+    return it;
+}
+
+// Advance the iterator; key points into the map and must not be freed
+bool iterNext(HashMapIterator *it, const char **key, int *value) {
+    while (it->entry == NULL) {
+        if (it->bucket >= it->map->capacity)
+            return false;
+        it->entry = it->map->buckets[it->bucket++];
+    }
+    
+    *key = entryKey(it->entry);
+    *value = it->entry->value;
+    it->entry = it->entry->next;
+    return true;
+}
+
+// Reverse the bits of a 64-bit cursor by swapping ever larger groups
+uint64_t reverseBits(uint64_t v) {
+    v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+    v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return __builtin_bswap64(v);
+}
+
+// Visit up to numBuckets buckets starting at cursor and return the cursor to
+// resume from (0 when done). The cursor counts in reverse-binary order over the
+// bucket mask, so when the table grows or shrinks between calls the buckets
+// already visited map onto the new buckets already covered: every key present
+// for the whole scan is reported at least once, with no state kept in the map.
+uint64_t scanHashMap(HashMap *map, uint64_t cursor, int numBuckets,
+                          ScanVisitor visit, void *context) {
+    finishRehash(map);
+    uint64_t mask = map->capacity - 1;
+    
+    do {
+        for (Entry *entry = map->buckets[cursor & mask]; entry != NULL; entry = entry->next)
+            visit(entryKey(entry), entry->value, context);
+        
+        // Increment the reversed cursor: set the bits above the mask, reverse, add, reverse
+        cursor |= ~mask;
+        cursor = reverseBits(cursor);
+        cursor++;
+        cursor = reverseBits(cursor);
+    } while (cursor != 0 && --numBuckets > 0);
+    
+    return cursor;
+}
+
+// Skewed bucket assignment: denser buckets are placed first while the table is empty
+uint32_t frozenBucket(FrozenHashMap *frozen, uint64_t hashValue) {
+    uint32_t high = (uint32_t)(hashValue >> 32);
+    const uint64_t split = (uint64_t)(0.6 * 4294967296.0);
+    
+    if (high < split)
+        return (uint32_t)((uint64_t)high * frozen->denseBuckets / split);
+    
+    return frozen->denseBuckets +
+           (uint32_t)((uint64_t)(high - split) * (frozen->numBuckets - frozen->denseBuckets) / (4294967296ULL - split));
+}
+
+// Position of a key for a given pilot; multiply-shift maps onto [0, numSlots) without division
+uint32_t frozenPosition(FrozenHashMap *frozen, uint64_t hashValue, uint32_t pilot) {
+    // Mix after combining: if the pilot were only XORed into an already mixed
+    // hash, two keys sharing their top bits would collide for every pilot
+    uint64_t mixed = mulFold(hashValue ^ mulFold(pilot + 1, 0xc4ceb9fe1a85ec53ULL), 0x9e3779b97f4a7c15ULL);
+    return (uint32_t)(((__uint128_t)mixed * (uint64_t)frozen->numSlots) >> 64);
+}
+
+// Final slot of a key in [0, numKeys)
+uint32_t frozenSlot(FrozenHashMap *frozen, uint64_t hashValue) {
+    uint32_t position = frozenPosition(frozen, hashValue, frozen->pilots[frozenBucket(frozen, hashValue)]);
+    return position < (uint32_t)frozen->numKeys ? position : frozen->remap[position - frozen->numKeys];
+}
+
+uint16_t frozenFingerprint(uint64_t hashValue) {
+    return (uint16_t)hashValue;
+}
+
+// Try to place every key with one seed; false if some bucket finds no pilot
+bool buildFrozenIndex(FrozenHashMap *frozen, uint64_t *hashes, int n) {
+    int numBuckets = frozen->numBuckets;
+    int *bucketStart = (int*)calloc(numBuckets + 1, sizeof(int));
+    int *order = (int*)malloc(n * sizeof(int));
+    uint32_t *bucketOf = (uint32_t*)malloc(n * sizeof(uint32_t));
+    bool *taken = (bool*)calloc(frozen->numSlots, sizeof(bool));
+    uint32_t positions[256];
+    bool ok = true;
+    
+    // Counting sort of keys by bucket
+    for (int i = 0; i < n; i++) {
+        bucketOf[i] = frozenBucket(frozen, hashes[i]);
+        bucketStart[bucketOf[i] + 1]++;
+    }
+    for (int b = 0; b < numBuckets; b++)
+        bucketStart[b + 1] += bucketStart[b];
+    
+    int *fill = (int*)malloc(numBuckets * sizeof(int));
+    memcpy(fill, bucketStart, numBuckets * sizeof(int));
+    for (int i = 0; i < n; i++)
+        order[fill[bucketOf[i]]++] = i;
+    
+    // Counting sort of buckets by size, largest first
+    int maxSize = 0;
+    for (int b = 0; b < numBuckets; b++) {
+        int size = bucketStart[b + 1] - bucketStart[b];
+        if (size > maxSize)
+            maxSize = size;
+    }
+    if (maxSize > 256)
+        ok = false;
+    
+    int *sizeStart = (int*)calloc(maxSize + 2, sizeof(int));
+    int *bucketsBySize = (int*)malloc(numBuckets * sizeof(int));
+    for (int b = 0; b < numBuckets; b++)
+        sizeStart[maxSize - (bucketStart[b + 1] - bucketStart[b]) + 1]++;
+    for (int s = 0; s <= maxSize; s++)
+        sizeStart[s + 1] += sizeStart[s];
+    for (int b = 0; b < numBuckets; b++)
+        bucketsBySize[sizeStart[maxSize - (bucketStart[b + 1] - bucketStart[b])]++] = b;
+    
+    for (int k = 0; ok && k < numBuckets; k++) {
+        int b = bucketsBySize[k];
+        int size = bucketStart[b + 1] - bucketStart[b];
+        frozen->pilots[b] = 0;
+        if (size == 0)
+            continue;
+        
+        // Smallest pilot that sends every key of the bucket to a distinct free slot
+        bool placed = false;
+        for (uint32_t pilot = 0; pilot <= FROZEN_MAX_PILOT && !placed; pilot++) {
+            placed = true;
+            for (int j = 0; j < size && placed; j++) {
+                uint32_t position = frozenPosition(frozen, hashes[order[bucketStart[b] + j]], pilot);
+                if (taken[position])
+                    placed = false;
+                for (int m = 0; m < j && placed; m++) {
+                    if (positions[m] == position)
+                        placed = false;
+                }
+                positions[j] = position;
+            }
+            
+            if (placed) {
+                frozen->pilots[b] = (uint16_t)pilot;
+                for (int j = 0; j < size; j++)
+                    taken[positions[j]] = true;
+            }
+        }
+        
+        ok = placed;
+    }
+    
+    // Pair each taken position past numKeys with a free slot below it; unused
+    // positions point at slot 0 so a missing key still lands on a valid slot
+    int freeSlot = 0;
+    for (int position = n; ok && position < frozen->numSlots; position++) {
+        frozen->remap[position - n] = 0;
+        if (taken[position]) {
+            while (taken[freeSlot])
+                freeSlot++;
+            frozen->remap[position - n] = freeSlot++;
+        }
+    }
+    
+    free(bucketStart);
+    free(order);
+    free(bucketOf);
+    free(taken);
+    free(fill);
+    free(sizeStart);
+    free(bucketsBySize);
+    return ok;
+}
+
+// Build a read-only copy of the map indexed by a minimal perfect hash.
+// The live map is left untouched; later changes to it are not reflected.
+FrozenHashMap* freezeHashMap(HashMap *map, bool withFingerprints) {
+    finishRehash(map);
+    int n = map->size;
+    
+    FrozenHashMap *frozen = (FrozenHashMap*)malloc(sizeof(FrozenHashMap));
+    frozen->numKeys = n;
+    frozen->numSlots = (int)(n / FROZEN_LOAD_FACTOR) + 1;
+    frozen->numBuckets = n / FROZEN_KEYS_PER_BUCKET + 1;
+    frozen->denseBuckets = (int)(0.3 * frozen->numBuckets) + 1;
+    if (frozen->denseBuckets >= frozen->numBuckets)
+        frozen->denseBuckets = frozen->numBuckets - 1;
+    frozen->pilots = (uint16_t*)malloc(frozen->numBuckets * sizeof(uint16_t));
+    frozen->remap = (uint32_t*)malloc((frozen->numSlots - n) * sizeof(uint32_t));
+    
+    Entry **entries = (Entry**)malloc((n > 0 ? n : 1) * sizeof(Entry*));
+    uint64_t *hashes = (uint64_t*)malloc((n > 0 ? n : 1) * sizeof(uint64_t));
+    int count = 0;
+    for (int b = 0; b < map->capacity; b++) {
+        for (Entry *entry = map->buckets[b]; entry != NULL; entry = entry->next)
+            entries[count++] = entry;
+    }
+    
+    // A fresh seed per attempt; identical 64-bit hashes or an unplaceable bucket force a retry
+    bool built = false;
+    for (int attempt = 0; attempt < FROZEN_MAX_ATTEMPTS && !built; attempt++) {
+        frozen->seed = mulFold(0x2545f4914f6cdd1dULL + attempt, 0x9e3779b97f4a7c15ULL);
+        for (int i = 0; i < n; i++)
+            hashes[i] = wymixHash(entryKey(entries[i]), frozen->seed);
+        built = buildFrozenIndex(frozen, hashes, n);
+    }
+    
+    if (!built) {
+        free(entries);
+        free(hashes);
+        free(frozen->pilots);
+        free(frozen->remap);
+        free(frozen);
+        return NULL;
+    }
+    
+    // Lay out values, fingerprints and keys by slot
+    size_t keyBytes = 0;
+    for (int i = 0; i < n; i++)
+        keyBytes += entries[i]->keyLength + 1;
+    
+    frozen->values = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    frozen->keyOffsets = (uint32_t*)malloc((n > 0 ? n : 1) * sizeof(uint32_t));
+    frozen->keys = (char*)malloc(keyBytes > 0 ? keyBytes : 1);
+    frozen->fingerprints = withFingerprints ? (uint16_t*)malloc((n > 0 ? n : 1) * sizeof(uint16_t)) : NULL;
+    
+    size_t offset = 0;
+    for (int i = 0; i < n; i++) {
+        uint32_t slot = frozenSlot(frozen, hashes[i]);
+        frozen->values[slot] = entries[i]->value;
+        frozen->keyOffsets[slot] = (uint32_t)offset;
+        if (withFingerprints)
+            frozen->fingerprints[slot] = frozenFingerprint(hashes[i]);
+        memcpy(frozen->keys + offset, entryKey(entries[i]), entries[i]->keyLength + 1);
+        offset += entries[i]->keyLength + 1;
+    }
+    
+    free(entries);
+    free(hashes);
+    return frozen;
+}
+
+// Get value for a key from a frozen map: exactly one slot is ever examined
+int frozenGet(FrozenHashMap *frozen, const char *key, bool *found) {
+    *found = false;
+    if (frozen->numKeys == 0)
+        return -1;
+    
+    uint64_t hashValue = wymixHash(key, frozen->seed);
+    uint32_t slot = frozenSlot(frozen, hashValue);
+    
+    if (frozen->fingerprints != NULL && frozen->fingerprints[slot] != frozenFingerprint(hashValue))
+        return -1;
+    
+    if (strcmp(frozen->keys + frozen->keyOffsets[slot], key) != 0)
+        return -1;
+    
+    *found = true;
+    return frozen->values[slot];
+}
+
+// Check if key exists in a frozen map
+bool frozenContainsKey(FrozenHashMap *frozen, const char *key) {
+    bool found;
+    frozenGet(frozen, key, &found);
+    return found;
+}
+
+// Free a frozen map
+void freeFrozenHashMap(FrozenHashMap *frozen) {
+    free(frozen->pilots);
+    free(frozen->remap);
+    free(frozen->fingerprints);
+    free(frozen->values);
+    free(frozen->keyOffsets);
+    free(frozen->keys);
+    free(frozen);
+}
+
+// Write the map as a flat, position-independent snapshot
+bool saveHashMap(HashMap *map, const char *path) {
+    uint64_t numSlots = 16;
+    while (numSlots < 2 * (uint64_t)map->size)
+        numSlots *= 2;
+    
+    SnapshotSlot *slots = (SnapshotSlot*)malloc(numSlots * sizeof(SnapshotSlot));
+    for (uint64_t i = 0; i < numSlots; i++)
+        slots[i].keyLength = SNAPSHOT_EMPTY_SLOT;
+    
+    // Linear probing on the same full hashes the live map already caches
+    finishRehash(map);
+    uint64_t keyBytes = 0;
+    for (int b = 0; b < map->capacity; b++) {
+        for (Entry *entry = map->buckets[b]; entry != NULL; entry = entry->next) {
+            uint64_t index = entry->hash & (numSlots - 1);
+            while (slots[index].keyLength != SNAPSHOT_EMPTY_SLOT)
+                index = (index + 1) & (numSlots - 1);
+            
+            slots[index].hash = entry->hash;
+            slots[index].keyOffset = keyBytes;
+            slots[index].keyLength = entry->keyLength;
+            slots[index].value = entry->value;
+            keyBytes += entry->keyLength;
+        }
+    }
+    
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, 8);
+    header.hashKind = map->hashKind;
+    header.seed = map->seed;
+    header.numSlots = numSlots;
+    header.numEntries = map->size;
+    header.slotsOffset = sizeof(SnapshotHeader);
+    header.keysOffset = header.slotsOffset + numSlots * sizeof(SnapshotSlot);
+    header.fileSize = header.keysOffset + keyBytes;
+    
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        free(slots);
+        return false;
+    }
+    
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(slots, sizeof(SnapshotSlot), numSlots, file) == numSlots;
+    
+    // Key bytes in the same order their offsets were handed out
+    for (int b = 0; ok && b < map->capacity; b++) {
+        for (Entry *entry = map->buckets[b]; ok && entry != NULL; entry = entry->next)
+            ok = fwrite(entryKey(entry), 1, entry->keyLength, file) == (size_t)entry->keyLength;
+    }
+    
+    ok = fclose(file) == 0 && ok;
+    free(slots);
+    return ok;
+}
+
+// Map a snapshot file for lookups. Nothing is read up front; pages are faulted
+// in by the lookups that touch them, so opening is O(1) in the map size.
+// The header is checked against the file so a truncated or corrupt snapshot
+// is rejected instead of read past its end; per-slot key ranges are checked
+// by the lookups themselves.
+MappedHashMap* openMappedHashMap(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SnapshotHeader)) {
+        close(fd);
+        return NULL;
+    }
+    
+    void *base = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return NULL;
+    
+    const SnapshotHeader *header = (const SnapshotHeader*)base;
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, 8) != 0 ||
+        header->fileSize != (uint64_t)info.st_size ||
+        header->hashKind >= HASH_KIND_COUNT ||
+        header->numSlots == 0 || (header->numSlots & (header->numSlots - 1)) != 0 ||
+        header->numEntries >= header->numSlots ||
+        header->slotsOffset < sizeof(SnapshotHeader) ||
+        header->slotsOffset % _Alignof(SnapshotSlot) != 0 ||
+        header->slotsOffset > header->fileSize ||
+        header->numSlots > (header->fileSize - header->slotsOffset) / sizeof(SnapshotSlot) ||
+        header->keysOffset < header->slotsOffset + header->numSlots * sizeof(SnapshotSlot) ||
+        header->keysOffset > header->fileSize) {
+        munmap(base, info.st_size);
+        return NULL;
+    }
+    
+    MappedHashMap *mapped = (MappedHashMap*)malloc(sizeof(MappedHashMap));
+    mapped->base = (const char*)base;
+    mapped->length = info.st_size;
+    mapped->header = header;
+    mapped->slots = (const SnapshotSlot*)(mapped->base + header->slotsOffset);
+    mapped->keys = mapped->base + header->keysOffset;
+    mapped->keysLength = header->fileSize - header->keysOffset;
+    mapped->hashFunction = hashFunctions[header->hashKind];
+    return mapped;
+}
+
+// Get value for a key from a mapped snapshot
+int mappedGet(MappedHashMap *mapped, const char *key, bool *found) {
+    uint64_t hashValue = mapped->hashFunction(key, mapped->header->seed);
+    uint64_t mask = mapped->header->numSlots - 1;
+    size_t keyLength = strlen(key);
+    uint64_t index = hashValue & mask;
+    
+    // At most one pass over the table, even if a corrupt file has no empty slot
+    for (uint64_t probes = 0; probes < mapped->header->numSlots; probes++, index = (index + 1) & mask) {
+        const SnapshotSlot *slot = &mapped->slots[index];
+        if (slot->keyLength == SNAPSHOT_EMPTY_SLOT)
+            break;
+        
+        // A key range outside the key area can only come from a corrupt file
+        if (slot->keyOffset > mapped->keysLength || slot->keyLength > mapped->keysLength - slot->keyOffset)
+            continue;
+        
+        if (slot->hash == hashValue && slot->keyLength == keyLength &&
+            memcmp(mapped->keys + slot->keyOffset, key, keyLength) == 0) {
+            *found = true;
+            return slot->value;
+        }
+    }
+    
+    *found = false;
+    return -1;
+}
+
+// Check if key exists in a mapped snapshot
+bool mappedContainsKey(MappedHashMap *mapped, const char *key) {
+    bool found;
+    mappedGet(mapped, key, &found);
+    return found;
+}
+
+// Unmap a snapshot
+void closeMappedHashMap(MappedHashMap *mapped) {
+    munmap((void*)mapped->base, mapped->length);
+    free(mapped);
+}
+
 // Clear all entries
 void clear(HashMap *map) {
+    // Arena mode: nothing to walk, drop the tables' contents and every slab
+    if (map->arena != NULL) {
+        if (isRehashing(map)) {
+            free(map->oldBuckets);
+            map->oldBuckets = NULL;
+            map->oldCapacity = 0;
+            map->rehashIndex = 0;
+        }
+        memset(map->buckets, 0, map->capacity * sizeof(Entry*));
+        resetArena(map->arena);
+        map->size = 0;
+        if (map->bloom != NULL)
+            rebuildBloomFilter(map);
+        return;
+    }
+    
+    finishRehash(map);
+    
     for (int i = 0; i < map->capacity; i++) {
         Entry *entry = map->buckets[i];
         while (entry != NULL) {
             Entry *next = entry->next;
-            free(entry->key);
-            free(entry);
+            freeEntry(map, entry);
             entry = next;
         }
         map->buckets[i] = NULL;
     }
     map->size = 0;
+    
+    // The table is empty now, so this just zeroes the filter
+    if (map->bloom != NULL)
+        rebuildBloomFilter(map);
 }
 
 // Check if map is empty
@@ -226,6 +1355,8 @@ int getSize(HashMap *map) {
 
 // Print the hash map
 void printHashMap(HashMap *map) {
+    finishRehash(map);
+    
     printf("HashMap (size: %d, capacity: %d, load factor: %.2f):\n", 
            map->size, map->capacity, getLoadFactor(map));
     
@@ -234,7 +1365,7 @@ void printHashMap(HashMap *map) {
             printf("Bucket %d: ", i);
             Entry *entry = map->buckets[i];
             while (entry != NULL) {
-                printf("[%s: %d] ", entry->key, entry->value);
+                printf("[%s: %d] ", entryKey(entry), entry->value);
                 entry = entry->next;
             }
             printf("\n");
@@ -242,13 +1373,587 @@ void printHashMap(HashMap *map) {
     }
 }
 
+// Print chain-length distribution and expected probes for a successful lookup
+void printBucketHistogram(HashMap *map) {
+    finishRehash(map);
+    
+    int histogram[9] = {0};  // Chains of length 0..7, then 8 or more
+    int maxChain = 0;
+    long probes = 0;
+    
+    for (int i = 0; i < map->capacity; i++) {
+        int length = 0;
+        for (Entry *entry = map->buckets[i]; entry != NULL; entry = entry->next)
+            length++;
+        
+        histogram[length < 8 ? length : 8]++;
+        if (length > maxChain)
+            maxChain = length;
+        
+        // The k-th entry in a chain takes k comparisons to find
+        probes += (long)length * (length + 1) / 2;
+    }
+    
+    printf("%-13s used: %5.1f%%  max chain: %2d  avg probes: %.3f  chains:",
+           hashNames[map->hashKind],
+           100.0 * (map->capacity - histogram[0]) / map->capacity, maxChain,
+           map->size > 0 ? (double)probes / map->size : 0.0);
+    for (int i = 0; i < 9; i++)
+        printf(" %d%s:%d", i, i == 8 ? "+" : "", histogram[i]);
+    printf("\n");
+}
+
 // Free the hash map
 void freeHashMap(HashMap *map) {
     clear(map);
+    enableBloomFilter(map, 0);
     free(map->buckets);
+    free(map->arena);
     free(map);
 }
 
+// Compare nanosecond latencies for qsort
+int compareLatency(const void *a, const void *b) {
+    long x = *(const long*)a;
+    long y = *(const long*)b;
+    return (x > y) - (x < y);
+}
+
+// Time every put() while growing a map from empty to n keys
+void benchmarkPutLatency(int n, bool incrementalRehash, int bloomBitsPerKey) {
+    char **keys = (char**)malloc(n * sizeof(char*));
+    long *latencies = (long*)malloc(n * sizeof(long));
+    
+    for (int i = 0; i < n; i++) {
+        keys[i] = (char*)malloc(20);
+        sprintf(keys[i], "key%d", i);
+    }
+    
+    HashMap *map = createHashMap();
+    map->incrementalRehash = incrementalRehash;
+    enableBloomFilter(map, bloomBitsPerKey);
+    
+    for (int i = 0; i < n; i++) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        put(map, keys[i], i);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        latencies[i] = (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec);
+    }
+    
+    qsort(latencies, n, sizeof(long), compareLatency);
+    printf("%-20s p50: %6ld ns  p99: %6ld ns  p999: %8ld ns  max: %10ld ns\n",
+           incrementalRehash ? (bloomBitsPerKey > 0 ? "incremental + bloom" : "incremental") : "full resize",
+           latencies[n / 2], latencies[(long)n * 99 / 100],
+           latencies[(long)n * 999 / 1000], latencies[n - 1]);
+    
+    freeHashMap(map);
+    for (int i = 0; i < n; i++)
+        free(keys[i]);
+    free(keys);
+    free(latencies);
+}
+
+// Resize time and miss-lookup cost on long keys that share a prefix (URLs, UUIDs)
+void benchmarkLongKeys(int n) {
+    char **keys = (char**)malloc(n * sizeof(char*));
+    char **misses = (char**)malloc(n * sizeof(char*));
+    
+    for (int i = 0; i < n; i++) {
+        keys[i] = (char*)malloc(96);
+        misses[i] = (char*)malloc(96);
+        sprintf(keys[i], "https://example.com/api/v1/users/%08x-4a3b-9c2d-%012d/profile", i * 2654435761u, i);
+        sprintf(misses[i], "https://example.com/api/v1/users/%08x-4a3b-9c2d-%012d/settings", i * 2654435761u, i);
+    }
+    
+    HashMap *map = createHashMap();
+    map->incrementalRehash = false;
+    for (int i = 0; i < n; i++)
+        put(map, keys[i], i);
+    
+    struct timespec start, end;
+    int hits = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++)
+        hits += containsKey(map, misses[i]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double missNs = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / n;
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    resize(map);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double resizeMs = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    
+    printf("%d long keys: resize %.1f ms, miss lookup %.1f ns (false hits: %d)\n",
+           n, resizeMs, missNs, hits);
+    
+    freeHashMap(map);
+    for (int i = 0; i < n; i++) {
+        free(keys[i]);
+        free(misses[i]);
+    }
+    free(keys);
+    free(misses);
+}
+
+// Memory per entry and hit-lookup latency for typical short keys
+void benchmarkShortKeys(int n) {
+    char **keys = (char**)malloc(n * sizeof(char*));
+    for (int i = 0; i < n; i++) {
+        keys[i] = (char*)malloc(24);
+        sprintf(keys[i], "user:%ld", (long)i * 7919);
+    }
+    
+    HashMap *map = createHashMap();
+    for (int i = 0; i < n; i++)
+        put(map, keys[i], i);
+    finishRehash(map);
+    
+    // Bytes and heap allocations owned per entry: the node plus any spilled key
+    long bytes = 0;
+    long allocations = 0;
+    for (int i = 0; i < map->capacity; i++) {
+        for (Entry *entry = map->buckets[i]; entry != NULL; entry = entry->next) {
+            bytes += sizeof(Entry);
+            allocations++;
+            if (!hasInlineKey(entry)) {
+                bytes += entry->keyLength + 1;
+                allocations++;
+            }
+        }
+    }
+    
+    // Look keys up in shuffled order so consecutive lookups hit unrelated buckets
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        char *temp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = temp;
+    }
+    
+    struct timespec start, end;
+    long sum = 0;
+    bool found;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++)
+        sum += get(map, keys[i], &found);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    printf("%d short keys: %.1f bytes and %.2f allocations per entry, hit lookup %.1f ns (checksum %ld)\n",
+           n, (double)bytes / n, (double)allocations / n,
+           ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / n, sum);
+    
+    freeHashMap(map);
+    for (int i = 0; i < n; i++)
+        free(keys[i]);
+    free(keys);
+}
+
+// Bulk ingestion followed by clear(), with malloc'd or arena-backed entries
+void benchmarkIngestion(int n, bool useArena) {
+    char **keys = (char**)malloc(n * sizeof(char*));
+    for (int i = 0; i < n; i++) {
+        keys[i] = (char*)malloc(20);
+        sprintf(keys[i], "key%d", i);
+    }
+    
+    HashMap *map = useArena ? createArenaHashMap() : createHashMap();
+    struct timespec start, mid, end;
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++)
+        put(map, keys[i], i);
+    clock_gettime(CLOCK_MONOTONIC, &mid);
+    clear(map);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    printf("%-7s insert: %.1f ns/key, clear: %.1f ms\n", useArena ? "arena" : "malloc",
+           ((mid.tv_sec - start.tv_sec) * 1e9 + (mid.tv_nsec - start.tv_nsec)) / n,
+           (end.tv_sec - mid.tv_sec) * 1e3 + (end.tv_nsec - mid.tv_nsec) / 1e6);
+    
+    freeHashMap(map);
+    for (int i = 0; i < n; i++)
+        free(keys[i]);
+    free(keys);
+}
+
+// Build one map per hash function from the same keys and compare their buckets
+void compareHashFunctions(const char *format, int n) {
+    char key[96];
+    
+    printf("\n%d keys of the form \"%s\":\n", n, format);
+    for (int kind = 0; kind < HASH_KIND_COUNT; kind++) {
+        HashMap *map = createHashMapWithHash((HashKind)kind);
+        for (int i = 0; i < n; i++) {
+            sprintf(key, format, i);
+            put(map, key, i);
+        }
+        printBucketHistogram(map);
+        freeHashMap(map);
+    }
+}
+
+// Lookup throughput of a get() loop vs getBatch() at several batch sizes
+void benchmarkBatchLookups(int n) {
+    const char **keys = (const char**)malloc(n * sizeof(char*));
+    int *values = (int*)malloc(n * sizeof(int));
+    bool *found = (bool*)malloc(n * sizeof(bool));
+    
+    for (int i = 0; i < n; i++) {
+        char *key = (char*)malloc(20);
+        sprintf(key, "key%d", i);
+        keys[i] = key;
+        values[i] = i;
+    }
+    
+    HashMap *map = createHashMap();
+    struct timespec start, end;
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    putBatch(map, keys, values, n);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("putBatch: %.1f ns/key\n", ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / n);
+    finishRehash(map);
+    
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        const char *temp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = temp;
+    }
+    
+    long sum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++)
+        sum += get(map, keys[i], &found[i]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("get() loop:        %.1f ns/key\n", ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / n);
+    
+    int batchSizes[] = {32, 64, 128, 256};
+    for (int b = 0; b < 4; b++) {
+        int batch = batchSizes[b];
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i + batch <= n; i += batch)
+            getBatch(map, keys + i, batch, values + i, found + i);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        for (int i = 0; i + batch <= n; i++)
+            sum += values[i];
+        printf("getBatch(%3d):     %.1f ns/key\n", batch,
+               ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / n);
+    }
+    printf("(checksum %ld)\n", sum);
+    
+    freeHashMap(map);
+    for (int i = 0; i < n; i++)
+        free((char*)keys[i]);
+    free(keys);
+    free(values);
+    free(found);
+}
+
+// Scan visitor that counts the keys present before the scan started
+void countEntry(const char *key, int value, void *context) {
+    long *totals = (long*)context;
+    if (strncmp(key, "key", 3) == 0) {
+        totals[0]++;
+        totals[1] += value;
+    }
+}
+
+// Export cost: getKeys()/getValues() deep copies vs the iterator vs chunked scan
+void benchmarkIteration(int n) {
+    HashMap *map = createHashMap();
+    char key[20];
+    for (int i = 0; i < n; i++) {
+        sprintf(key, "key%d", i);
+        put(map, key, i);
+    }
+    finishRehash(map);
+    
+    struct timespec start, end;
+    long total = 0;
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int numKeys, numValues;
+    char **keys = getKeys(map, &numKeys);
+    int *values = getValues(map, &numValues);
+    for (int i = 0; i < numKeys; i++) {
+        total += strlen(keys[i]) + values[i];
+        free(keys[i]);
+    }
+    free(keys);
+    free(values);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("getKeys/getValues: %.1f ms, %d allocations\n",
+           (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6, numKeys + 2);
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    HashMapIterator it = iterBegin(map);
+    const char *iterKey;
+    int iterValue;
+    while (iterNext(&it, &iterKey, &iterValue))
+        total += strlen(iterKey) + iterValue;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("iterator:          %.1f ms, 0 allocations\n",
+           (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    
+    // Stream in chunks of 4096 buckets, inserting new keys between chunks
+    long totals[2] = {0, 0};
+    int chunks = 0;
+    uint64_t cursor = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+        cursor = scanHashMap(map, cursor, 4096, countEntry, totals);
+        sprintf(key, "late%d", chunks++);
+        put(map, key, 0);
+    } while (cursor != 0);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("scan (%d chunks):  %.1f ms, %ld visits for %d original keys while %d were added\n",
+           chunks, (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6,
+           totals[0], n, chunks);
+    
+    printf("(checksum %ld)\n", total + totals[1]);
+    freeHashMap(map);
+}
+
+// Bulk delete down to 1% of the keys: bucket array size and iteration time
+// with the table left as is, shrunk automatically, or shrunk with shrinkToFit()
+void benchmarkShrink(int n) {
+    const char *labels[] = {"no shrink", "auto shrink", "shrinkToFit"};
+    char key[20];
+    
+    for (int mode = 0; mode < 3; mode++) {
+        HashMap *map = createHashMap();
+        map->autoShrink = mode == 1;
+        for (int i = 0; i < n; i++) {
+            sprintf(key, "key%d", i);
+            put(map, key, i);
+        }
+        for (int i = 0; i < n; i++) {
+            if (i % 100 != 0) {
+                sprintf(key, "key%d", i);
+                removeKey(map, key);
+            }
+        }
+        if (mode == 2)
+            shrinkToFit(map);
+        finishRehash(map);
+        
+        struct timespec start, end;
+        long total = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        HashMapIterator it = iterBegin(map);
+        const char *iterKey;
+        int iterValue;
+        while (iterNext(&it, &iterKey, &iterValue))
+            total += iterValue;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        
+        printf("%-12s %d keys in %8d buckets (%6.1f KB), iterate: %.3f ms (checksum %ld)\n",
+               labels[mode], getSize(map), map->capacity, map->capacity * sizeof(Entry*) / 1024.0,
+               (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6, total);
+        freeHashMap(map);
+    }
+}
+
+// Bulk load of n keys with and without reserve(n) up front
+void benchmarkReserve(int n) {
+    char **keys = (char**)malloc(n * sizeof(char*));
+    for (int i = 0; i < n; i++) {
+        keys[i] = (char*)malloc(20);
+        sprintf(keys[i], "key%d", i);
+    }
+    
+    for (int presize = 0; presize < 2; presize++) {
+        HashMap *map = createHashMap();
+        struct timespec start, end;
+        int resizes = 0;
+        
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (presize)
+            reserve(map, n);
+        int capacity = map->capacity;
+        for (int i = 0; i < n; i++) {
+            put(map, keys[i], i);
+            if (map->capacity != capacity) {
+                capacity = map->capacity;
+                resizes++;
+            }
+        }
+        finishRehash(map);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        
+        printf("%-12s %.1f ns/key, %d resizes\n", presize ? "reserve(n)" : "grow",
+               ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / n, resizes);
+        freeHashMap(map);
+    }
+    
+    for (int i = 0; i < n; i++)
+        free(keys[i]);
+    free(keys);
+}
+
+// Lookups of absent keys (and, for scale, present ones) with and without a
+// Bloom filter in front of the buckets, plus the filter's false-positive rate
+void benchmarkBloomFilter(int n, int bitsPerKey) {
+    char **hits = (char**)malloc(n * sizeof(char*));
+    char **misses = (char**)malloc(n * sizeof(char*));
+    for (int i = 0; i < n; i++) {
+        hits[i] = (char*)malloc(20);
+        misses[i] = (char*)malloc(20);
+        sprintf(hits[i], "key%d", i);
+        sprintf(misses[i], "absent%d", i);
+    }
+    
+    for (int withBloom = 0; withBloom < 2; withBloom++) {
+        HashMap *map = createHashMap();
+        if (withBloom)
+            enableBloomFilter(map, bitsPerKey);
+        for (int i = 0; i < n; i++)
+            put(map, hits[i], i);
+        finishRehash(map);
+        
+        struct timespec start, mid, end;
+        long found = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < n; i++)
+            found += containsKey(map, misses[i]);
+        clock_gettime(CLOCK_MONOTONIC, &mid);
+        for (int i = 0; i < n; i++)
+            found += containsKey(map, hits[i]);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        
+        printf("%-13s miss: %5.1f ns  hit: %5.1f ns", withBloom ? "bloom filter" : "no filter",
+               ((mid.tv_sec - start.tv_sec) * 1e9 + (mid.tv_nsec - start.tv_nsec)) / n,
+               ((end.tv_sec - mid.tv_sec) * 1e9 + (end.tv_nsec - mid.tv_nsec)) / n);
+        
+        if (withBloom) {
+            int passed = 0;
+            for (int i = 0; i < n; i++)
+                passed += bloomMayContain(map->bloom, hashKey(map, misses[i]));
+            printf("  (%d bits/key, %.1f KB, %.2f%% of misses reach the buckets)",
+                   bitsPerKey, map->bloom->numBlocks * BLOOM_BLOCK_WORDS * 8 / 1024.0, 100.0 * passed / n);
+        }
+        printf("  found %ld\n", found);
+        freeHashMap(map);
+    }
+    
+    for (int i = 0; i < n; i++) {
+        free(hits[i]);
+        free(misses[i]);
+    }
+    free(hits);
+    free(misses);
+}
+
+// Restart cost: rebuilding with put() vs mapping a saved snapshot
+void benchmarkSnapshot(int n, const char *path) {
+    char key[20];
+    HashMap *map = createHashMap();
+    struct timespec start, end;
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) {
+        sprintf(key, "key%d", i);
+        put(map, key, i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double rebuildMs = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool saved = saveHashMap(map, path);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double saveMs = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+    freeHashMap(map);
+    
+    if (!saved) {
+        printf("Could not write %s\n", path);
+        return;
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    MappedHashMap *mapped = openMappedHashMap(path);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double openUs = (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3;
+    
+    long mismatches = 0;
+    bool found;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) {
+        sprintf(key, "key%d", i);
+        if (mappedGet(mapped, key, &found) != i || !found)
+            mismatches++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double lookupNs = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / n;
+    
+    printf("rebuild with put(): %.1f ms, save: %.1f ms, open: %.1f us, mapped get: %.1f ns (%ld mismatches)\n",
+           rebuildMs, saveMs, openUs, lookupNs, mismatches);
+    
+    closeMappedHashMap(mapped);
+    remove(path);
+}
+
+// Build cost and lookup latency of a frozen map vs the mutable map it came from
+void benchmarkFreeze(int n) {
+    char **keys = (char**)malloc(n * sizeof(char*));
+    char **misses = (char**)malloc(n * sizeof(char*));
+    for (int i = 0; i < n; i++) {
+        keys[i] = (char*)malloc(20);
+        misses[i] = (char*)malloc(20);
+        sprintf(keys[i], "key%d", i);
+        sprintf(misses[i], "miss%d", i);
+    }
+    
+    HashMap *map = createHashMap();
+    for (int i = 0; i < n; i++)
+        put(map, keys[i], i);
+    finishRehash(map);
+    
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        char *temp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = temp;
+    }
+    
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    FrozenHashMap *frozen = freezeHashMap(map, true);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (frozen == NULL) {
+        printf("freeze failed\n");
+        freeHashMap(map);
+        return;
+    }
+    printf("freeze: %.1f ms, index: %.2f bits/key (+16 bits/key of fingerprints)\n",
+           (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6,
+           (16.0 * frozen->numBuckets + 32.0 * (frozen->numSlots - n)) / n);
+    
+    long hits = 0;
+    double times[4];
+    char **sets[2] = {keys, misses};
+    for (int t = 0; t < 4; t++) {
+        char **set = sets[t % 2];
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < n; i++)
+            hits += t < 2 ? containsKey(map, set[i]) : frozenContainsKey(frozen, set[i]);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        times[t] = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / n;
+    }
+    printf("mutable: hit %.1f ns, miss %.1f ns | frozen: hit %.1f ns, miss %.1f ns (hits: %ld)\n",
+           times[0], times[1], times[2], times[3], hits);
+    
+    freeFrozenHashMap(frozen);
+    freeHashMap(map);
+    for (int i = 0; i < n; i++) {
+        free(keys[i]);
+        free(misses[i]);
+    }
+    free(keys);
+    free(misses);
+}
+
 // Example usage
 int main() {
     HashMap *map = createHashMap();
@@ -303,6 +2008,15 @@ int main() {
     free(values);
     printf("\n");
     
+    // Iterate in place without copying keys
+    printf("Iterating: ");
+    HashMapIterator it = iterBegin(map);
+    const char *iterKey;
+    int iterValue;
+    while (iterNext(&it, &iterKey, &iterValue))
+        printf("%s=%d ", iterKey, iterValue);
+    printf("\n");
+    
     // Remove a key
     printf("\nRemoving 'banana'...\n");
     removeKey(map, "banana");
@@ -318,6 +2032,71 @@ int main() {
     
     printHashMap(map);
     
+    // Drop most keys; the table shrinks back once it is mostly empty
+    printf("\nRemoving key0..key17...\n");
+    for (int i = 0; i < 18; i++) {
+        char key[20];
+        sprintf(key, "key%d", i);
+        removeKey(map, key);
+    }
+    finishRehash(map);
+    printf("Size: %d, capacity: %d\n", getSize(map), map->capacity);
+    
+    // Presize for a known number of keys, then give the space back
+    reserve(map, 1000);
+    printf("After reserve(1000): capacity %d\n", map->capacity);
+    shrinkToFit(map);
+    printf("After shrinkToFit(): capacity %d\n", map->capacity);
+    
+    // Re-add them for the snapshot and freeze examples
+    for (int i = 0; i < 18; i++) {
+        char key[20];
+        sprintf(key, "key%d", i);
+        put(map, key, i * 10);
+    }
+    
+    // Save a snapshot and serve lookups straight from the mapped file
+    printf("\nSaving snapshot and mapping it back...\n");
+    if (saveHashMap(map, "hashmap.snapshot")) {
+        MappedHashMap *mapped = openMappedHashMap("hashmap.snapshot");
+        if (mapped != NULL) {
+            value = mappedGet(mapped, "key7", &found);
+            printf("key7 from snapshot: %s (value: %d)\n", found ? "found" : "not found", value);
+            printf("Snapshot contains 'banana': %s\n", mappedContainsKey(mapped, "banana") ? "yes" : "no");
+            closeMappedHashMap(mapped);
+        }
+        
+        // A truncated copy must be rejected, not read past its end
+        struct stat info;
+        if (stat("hashmap.snapshot", &info) == 0 && truncate("hashmap.snapshot", info.st_size / 2) == 0) {
+            mapped = openMappedHashMap("hashmap.snapshot");
+            printf("Truncated snapshot: %s\n", mapped == NULL ? "rejected" : "accepted");
+            if (mapped != NULL)
+                closeMappedHashMap(mapped);
+        }
+        remove("hashmap.snapshot");
+    }
+    
+    // Freeze the current keys into a read-only perfect-hash map
+    printf("\nFreezing map...\n");
+    FrozenHashMap *frozen = freezeHashMap(map, true);
+    if (frozen != NULL) {
+        value = frozenGet(frozen, "key12", &found);
+        printf("key12 from frozen map: %s (value: %d)\n", found ? "found" : "not found", value);
+        printf("Frozen map contains 'cherry': %s\n", frozenContainsKey(frozen, "cherry") ? "yes" : "no");
+        freeFrozenHashMap(frozen);
+    }
+    
+    // Reject absent keys before any chain is walked
+    enableBloomFilter(map, BLOOM_DEFAULT_BITS_PER_KEY);
+    printf("\nWith a Bloom filter: contains 'key3': %s, contains 'cherry': %s\n",
+           containsKey(map, "key3") ? "yes" : "no", containsKey(map, "cherry") ? "yes" : "no");
+    
+    // Compare bucket distribution of the available hash functions
+    compareHashFunctions("key%d", 100000);
+    compareHashFunctions("https://example.com/item/%d", 100000);
+    compareHashFunctions("%d", 100000);
+    
     // Clear the map
     printf("\nClearing map...\n");
     clear(map);
@@ -327,5 +2106,39 @@ int main() {
     // Free memory
     freeHashMap(map);
     
+    // put() tail latency with stop-the-world vs incremental rehashing
+    printf("\nput() latency over 2M inserts:\n");
+    benchmarkPutLatency(1 << 21, false, 0);
+    benchmarkPutLatency(1 << 21, true, 0);
+    benchmarkPutLatency(1 << 21, true, BLOOM_DEFAULT_BITS_PER_KEY);
+    
+    benchmarkLongKeys(1 << 20);
+    benchmarkShortKeys(1 << 20);
+    
+    printf("\nFreezing 1M keys:\n");
+    benchmarkFreeze(1 << 20);
+    
+    printf("\nRestarting with 2M keys:\n");
+    benchmarkSnapshot(1 << 21, "hashmap_bench.snapshot");
+    
+    printf("\nExporting 2M keys:\n");
+    benchmarkIteration(1 << 21);
+    
+    printf("\nDeleting 99%% of 2M keys:\n");
+    benchmarkShrink(1 << 21);
+    
+    printf("\nBulk loading 2M keys:\n");
+    benchmarkReserve(1 << 21);
+    
+    printf("\nLookups with 2M keys:\n");
+    benchmarkBloomFilter(1 << 21, BLOOM_DEFAULT_BITS_PER_KEY);
+    
+    printf("\nBatched access over 2M keys:\n");
+    benchmarkBatchLookups(1 << 21);
+    
+    printf("\nIngestion of 2M keys:\n");
+    benchmarkIngestion(1 << 21, false);
+    benchmarkIngestion(1 << 21, true);
+    
     return 0;
 }
@@ -24,10 +24,14 @@ public class HashMap {
         this.buckets = new Entry[capacity];
     }
     
-    // Hash function
+    // Hash function: spread the high bits into the low ones, then mask
+    // (capacity is always a power of two, so no division is needed)
     private int hash(String key) {
         int hashValue = key.hashCode();
-        return Math.abs(hashValue) % capacity;
+        hashValue ^= hashValue >>> 16;
+        hashValue *= 0x85ebca6b;
+        hashValue ^= hashValue >>> 13;
+        return hashValue & (capacity - 1);
     }
     
     // Get load factor
@@ -35,21 +39,25 @@ public class HashMap {
         return (double) size / capacity;
     }
     
-    // Resize and rehash the map
+    // Resize and rehash the map. Entries are relinked into their new buckets
+    // directly: keys are distinct, so there is no duplicate check, no load
+    // factor check and no new Entry per move.
     private void resize() {
         int oldCapacity = capacity;
         Entry[] oldBuckets = buckets;
         
         capacity *= 2;
         buckets = new Entry[capacity];
-        size = 0;
         
         // Rehash all entries
         for (int i = 0; i < oldCapacity; i++) {
             Entry entry = oldBuckets[i];
             while (entry != null) {
-                put(entry.key, entry.value);
-                entry = entry.next;
+                Entry next = entry.next;
+                int index = hash(entry.key);
+                entry.next = buckets[index];
+                buckets[index] = entry;
+                entry = next;
             }
         }
     }
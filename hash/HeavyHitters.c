@@ -0,0 +1,535 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#define SKETCH_DEPTH 4
+
+// Count-min sketch: depth rows of width counters. A key's count is the
+// minimum of its counters, which never underestimates the true count and
+// overestimates by at most (total events) * e / width with high probability.
+typedef struct CountMinSketch {
+    uint32_t *counters;
+    int width;          // Power of two
+    long total;         // Events seen
+} CountMinSketch;
+
+typedef struct HeapEntry {
+    char *key;
+    uint64_t hash;
+    uint32_t count;
+    int slot;           // Position of this entry in the tracker's lookup table
+} HeapEntry;
+
+// Fixed-memory streaming top-k: the sketch counts every key, and a min-heap
+// keeps the k keys with the highest estimates, the smallest at the root. A
+// small open-addressing table maps heap keys to their heap positions.
+typedef struct HeavyHitters {
+    CountMinSketch sketch;
+    HeapEntry *heap;
+    int k;
+    int size;
+    int *table;         // Heap position + 1, 0 marks an empty slot
+    int tableSize;      // Power of two, at least 2k
+} HeavyHitters;
+
+// 64x64 -> 128-bit multiply folded back to 64 bits
+static inline uint64_t mulFold(uint64_t a, uint64_t b) {
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+// wyhash-style hash, same as HashMap.c's default
+uint64_t hash(const char *key) {
+    size_t length = strlen(key);
+    uint64_t hashValue = 0xa0761d6478bd642fULL;
+    uint64_t word;
+
+    while (length >= 8) {
+        memcpy(&word, key, 8);
+        hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL);
+        key += 8;
+        length -= 8;
+    }
+
+    word = 0;
+    memcpy(&word, key, length);
+    hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL ^ length);
+    return mulFold(hashValue, 0x8ebc6af09c88c6e3ULL);
+}
+
+// ---------------------------------------------------------------------------
+// Count-min sketch
+// ---------------------------------------------------------------------------
+
+// Counter of a hash in one row. Each row remixes the hash with its own
+// multiplier: with plain double hashing (h1 + row * h2) two keys that agree on
+// h1 and h2 collide in every row, which at small widths is not rare.
+static inline uint32_t* sketchCounter(CountMinSketch *sketch, uint64_t hashValue, int row) {
+    static const uint64_t rowSeeds[SKETCH_DEPTH] = {
+        0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL, 0x165667b19e3779f9ULL, 0xd6e8feb86659fd93ULL
+    };
+    uint64_t index = mulFold(hashValue, rowSeeds[row]) & (sketch->width - 1);
+    return &sketch->counters[(size_t)row * sketch->width + index];
+}
+
+// Count one event and return the key's new estimate. Conservative update: only
+// counters at the current minimum are raised, the others already overcount.
+uint32_t sketchAdd(CountMinSketch *sketch, uint64_t hashValue) {
+    uint32_t *counters[SKETCH_DEPTH];
+    uint32_t estimate = UINT32_MAX;
+
+    for (int row = 0; row < SKETCH_DEPTH; row++) {
+        counters[row] = sketchCounter(sketch, hashValue, row);
+        if (*counters[row] < estimate)
+            estimate = *counters[row];
+    }
+
+    estimate++;
+    for (int row = 0; row < SKETCH_DEPTH; row++) {
+        if (*counters[row] < estimate)
+            *counters[row] = estimate;
+    }
+
+    sketch->total++;
+    return estimate;
+}
+
+uint32_t sketchEstimate(CountMinSketch *sketch, uint64_t hashValue) {
+    uint32_t estimate = UINT32_MAX;
+    for (int row = 0; row < SKETCH_DEPTH; row++) {
+        uint32_t count = *sketchCounter(sketch, hashValue, row);
+        if (count < estimate)
+            estimate = count;
+    }
+    return estimate;
+}
+
+// ---------------------------------------------------------------------------
+// Top-k min-heap (the sift logic of MaxHeapify in sorting/heap_sort.c, with
+// the comparisons flipped and the lookup table kept in step with every swap)
+// ---------------------------------------------------------------------------
+
+void swapEntries(HeavyHitters *tracker, int i, int j) {
+    HeapEntry temp = tracker->heap[i];
+    tracker->heap[i] = tracker->heap[j];
+    tracker->heap[j] = temp;
+
+    tracker->table[tracker->heap[i].slot] = i + 1;
+    tracker->table[tracker->heap[j].slot] = j + 1;
+}
+
+void MinHeapify(HeavyHitters *tracker, int heap_size, int i) {
+    HeapEntry *heap = tracker->heap;
+    int left = 2 * i + 1;
+    int right = 2 * i + 2;
+    int smallest = i;
+
+    if (left < heap_size && heap[left].count < heap[smallest].count) {
+        smallest = left;
+    }
+
+    if (right < heap_size && heap[right].count < heap[smallest].count) {
+        smallest = right;
+    }
+
+    if (smallest != i) {
+        swapEntries(tracker, i, smallest);
+
+        MinHeapify(tracker, heap_size, smallest);
+    }
+}
+
+void BuildMinHeap(HeavyHitters *tracker, int size) {
+    for (int i = size / 2 - 1; i >= 0; i--) {
+        MinHeapify(tracker, size, i);
+    }
+}
+
+// Table slot for a key: its current slot if it is in the heap, otherwise the
+// empty slot where it would go
+int findTableSlot(HeavyHitters *tracker, const char *key, uint64_t hashValue) {
+    int mask = tracker->tableSize - 1;
+    int slot = (int)(hashValue & mask);
+
+    while (tracker->table[slot] != 0) {
+        HeapEntry *entry = &tracker->heap[tracker->table[slot] - 1];
+        if (entry->hash == hashValue && strcmp(entry->key, key) == 0)
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+// Empty a table slot with backward-shift deletion, fixing up the moved
+// entries' slot fields
+void removeTableSlot(HeavyHitters *tracker, int hole) {
+    int mask = tracker->tableSize - 1;
+    int slot = hole;
+
+    for (;;) {
+        slot = (slot + 1) & mask;
+        if (tracker->table[slot] == 0)
+            break;
+
+        HeapEntry *entry = &tracker->heap[tracker->table[slot] - 1];
+        int home = (int)(entry->hash & mask);
+        bool homeInRange = hole <= slot ? (hole < home && home <= slot)
+                                        : (hole < home || home <= slot);
+        if (!homeInRange) {
+            tracker->table[hole] = tracker->table[slot];
+            entry->slot = hole;
+            hole = slot;
+        }
+    }
+
+    tracker->table[hole] = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Tracker
+// ---------------------------------------------------------------------------
+
+// Track the top k keys with a sketch of SKETCH_DEPTH x width counters; NULL
+// unless k >= 1
+HeavyHitters* createHeavyHitters(int k, int width) {
+    if (k < 1)
+        return NULL;
+
+    HeavyHitters *tracker = (HeavyHitters*)malloc(sizeof(HeavyHitters));
+
+    tracker->sketch.width = 16;
+    while (tracker->sketch.width < width)
+        tracker->sketch.width *= 2;
+    tracker->sketch.counters = (uint32_t*)calloc((size_t)SKETCH_DEPTH * tracker->sketch.width, sizeof(uint32_t));
+    tracker->sketch.total = 0;
+
+    tracker->k = k;
+    tracker->size = 0;
+    tracker->heap = (HeapEntry*)malloc(k * sizeof(HeapEntry));
+    tracker->tableSize = 16;
+    while (tracker->tableSize < 2 * k)
+        tracker->tableSize *= 2;
+    tracker->table = (int*)calloc(tracker->tableSize, sizeof(int));
+
+    return tracker;
+}
+
+// Record one event for key: one hash, one sketch update, at most one heap fix-up
+void addEvent(HeavyHitters *tracker, const char *key) {
+    uint64_t hashValue = hash(key);
+    uint32_t count = sketchAdd(&tracker->sketch, hashValue);
+
+    // Already a heavy hitter: its count grew, so it can only move down
+    int slot = findTableSlot(tracker, key, hashValue);
+    if (tracker->table[slot] != 0) {
+        int position = tracker->table[slot] - 1;
+        tracker->heap[position].count = count;
+        if (tracker->size == tracker->k)
+            MinHeapify(tracker, tracker->size, position);
+        return;
+    }
+
+    // Heap order is only needed once eviction starts, so fill first, then build
+    if (tracker->size < tracker->k) {
+        HeapEntry *entry = &tracker->heap[tracker->size];
+        entry->key = (char*)malloc(strlen(key) + 1);
+        strcpy(entry->key, key);
+        entry->hash = hashValue;
+        entry->count = count;
+        entry->slot = slot;
+        tracker->table[slot] = ++tracker->size;
+
+        if (tracker->size == tracker->k)
+            BuildMinHeap(tracker, tracker->size);
+        return;
+    }
+
+    // Replace the smallest heavy hitter if this key now outranks it
+    HeapEntry *root = &tracker->heap[0];
+    if (count <= root->count)
+        return;
+
+    removeTableSlot(tracker, root->slot);
+    slot = findTableSlot(tracker, key, hashValue);
+
+    free(root->key);
+    root->key = (char*)malloc(strlen(key) + 1);
+    strcpy(root->key, key);
+    root->hash = hashValue;
+    root->count = count;
+    root->slot = slot;
+    tracker->table[slot] = 1;
+
+    MinHeapify(tracker, tracker->size, 0);
+}
+
+// Approximate count of any key, tracked or not
+uint32_t estimateCount(HeavyHitters *tracker, const char *key) {
+    return sketchEstimate(&tracker->sketch, hash(key));
+}
+
+int compareByCountDescending(const void *a, const void *b) {
+    uint32_t x = ((const HeapEntry*)a)->count;
+    uint32_t y = ((const HeapEntry*)b)->count;
+    return (x < y) - (x > y);
+}
+
+// Copy the current top keys into out (at most k), highest count first; keys
+// are borrowed from the tracker
+int topKeys(HeavyHitters *tracker, HeapEntry *out) {
+    memcpy(out, tracker->heap, tracker->size * sizeof(HeapEntry));
+    qsort(out, tracker->size, sizeof(HeapEntry), compareByCountDescending);
+    return tracker->size;
+}
+
+// Bytes held by the tracker, independent of how many distinct keys it has seen
+size_t trackerBytes(HeavyHitters *tracker) {
+    size_t bytes = sizeof(HeavyHitters) + (size_t)SKETCH_DEPTH * tracker->sketch.width * sizeof(uint32_t) +
+                   tracker->k * sizeof(HeapEntry) + tracker->tableSize * sizeof(int);
+    for (int i = 0; i < tracker->size; i++)
+        bytes += strlen(tracker->heap[i].key) + 1;
+    return bytes;
+}
+
+void freeHeavyHitters(HeavyHitters *tracker) {
+    for (int i = 0; i < tracker->size; i++)
+        free(tracker->heap[i].key);
+    free(tracker->heap);
+    free(tracker->table);
+    free(tracker->sketch.counters);
+    free(tracker);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark against exact counting with put(map, key, get(...) + 1)
+// ---------------------------------------------------------------------------
+
+typedef struct Entry {
+    char *key;
+    int value;
+    struct Entry *next;
+} Entry;
+
+// Minimal chained map for the exact counts
+typedef struct HashMap {
+    Entry **buckets;
+    int capacity;
+    int size;
+} HashMap;
+
+HashMap* createHashMap() {
+    HashMap *map = (HashMap*)malloc(sizeof(HashMap));
+    map->capacity = 16;
+    map->size = 0;
+    map->buckets = (Entry**)calloc(map->capacity, sizeof(Entry*));
+    return map;
+}
+
+void resize(HashMap *map) {
+    Entry **oldBuckets = map->buckets;
+    int oldCapacity = map->capacity;
+    map->capacity *= 2;
+    map->buckets = (Entry**)calloc(map->capacity, sizeof(Entry*));
+
+    for (int i = 0; i < oldCapacity; i++) {
+        Entry *entry = oldBuckets[i];
+        while (entry != NULL) {
+            Entry *next = entry->next;
+            unsigned int index = hash(entry->key) & (map->capacity - 1);
+            entry->next = map->buckets[index];
+            map->buckets[index] = entry;
+            entry = next;
+        }
+    }
+    free(oldBuckets);
+}
+
+int get(HashMap *map, const char *key, bool *found) {
+    for (Entry *entry = map->buckets[hash(key) & (map->capacity - 1)]; entry != NULL; entry = entry->next) {
+        if (strcmp(entry->key, key) == 0) {
+            *found = true;
+            return entry->value;
+        }
+    }
+    *found = false;
+    return 0;
+}
+
+void put(HashMap *map, const char *key, int value) {
+    unsigned int index = hash(key) & (map->capacity - 1);
+    for (Entry *entry = map->buckets[index]; entry != NULL; entry = entry->next) {
+        if (strcmp(entry->key, key) == 0) {
+            entry->value = value;
+            return;
+        }
+    }
+
+    if (map->size >= map->capacity * 3 / 4) {
+        resize(map);
+        index = hash(key) & (map->capacity - 1);
+    }
+
+    Entry *entry = (Entry*)malloc(sizeof(Entry));
+    entry->key = (char*)malloc(strlen(key) + 1);
+    strcpy(entry->key, key);
+    entry->value = value;
+    entry->next = map->buckets[index];
+    map->buckets[index] = entry;
+    map->size++;
+}
+
+void freeHashMap(HashMap *map) {
+    for (int i = 0; i < map->capacity; i++) {
+        Entry *entry = map->buckets[i];
+        while (entry != NULL) {
+            Entry *next = entry->next;
+            free(entry->key);
+            free(entry);
+            entry = next;
+        }
+    }
+    free(map->buckets);
+    free(map);
+}
+
+double elapsedSeconds(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Zipf(s) sample of n key ranks out of numKeys
+int* zipfStream(int numKeys, int n, double s, unsigned int seed) {
+    double *cdf = (double*)malloc(numKeys * sizeof(double));
+    double total = 0;
+    for (int i = 0; i < numKeys; i++) {
+        total += 1.0 / pow(i + 1, s);
+        cdf[i] = total;
+    }
+
+    int *stream = (int*)malloc(n * sizeof(int));
+    srand(seed);
+    for (int i = 0; i < n; i++) {
+        double u = (double)rand() / ((double)RAND_MAX + 1) * total;
+        int low = 0, high = numKeys - 1;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (cdf[mid] < u)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        stream[i] = low;
+    }
+
+    free(cdf);
+    return stream;
+}
+
+void benchmark(int numKeys, int n, int k, int width) {
+    char **keys = (char**)malloc(numKeys * sizeof(char*));
+    for (int i = 0; i < numKeys; i++) {
+        keys[i] = (char*)malloc(24);
+        sprintf(keys[i], "item:%d", i);
+    }
+    int *stream = zipfStream(numKeys, n, 1.1, 7);
+
+    struct timespec start, end;
+    bool found;
+
+    HashMap *exact = createHashMap();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) {
+        const char *key = keys[stream[i]];
+        put(exact, key, get(exact, key, &found) + 1);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double exactRate = n / elapsedSeconds(start, end);
+    size_t exactBytes = exact->capacity * sizeof(Entry*);
+    for (int i = 0; i < exact->capacity; i++)
+        for (Entry *entry = exact->buckets[i]; entry != NULL; entry = entry->next)
+            exactBytes += sizeof(Entry) + strlen(entry->key) + 1;
+
+    HeavyHitters *tracker = createHeavyHitters(k, width);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++)
+        addEvent(tracker, keys[stream[i]]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double sketchRate = n / elapsedSeconds(start, end);
+
+    // Ranks are the true popularity order, so the true top k are ranks 0..k-1
+    // (up to ties in the sampled counts); check reported keys against exact counts
+    HeapEntry *top = (HeapEntry*)malloc(k * sizeof(HeapEntry));
+    int reported = topKeys(tracker, top);
+    int recalled = 0;
+    double relativeError = 0;
+    for (int i = 0; i < reported; i++) {
+        int rank = atoi(top[i].key + 5);
+        if (rank < k)
+            recalled++;
+        int count = get(exact, top[i].key, &found);
+        relativeError += (double)(top[i].count - count) / count;
+    }
+
+    // Average overestimate over every distinct key, as a share of all events
+    double overestimate = 0;
+    int distinct = 0;
+    for (int i = 0; i < numKeys; i++) {
+        int count = get(exact, keys[i], &found);
+        if (found) {
+            overestimate += estimateCount(tracker, keys[i]) - count;
+            distinct++;
+        }
+    }
+
+    printf("%d events over %d keys (Zipf 1.1, %d distinct seen), top %d, sketch %d x %d:\n",
+           n, numKeys, distinct, k, SKETCH_DEPTH, tracker->sketch.width);
+    printf("exact HashMap:  %6.2f M events/s, %7.1f MB\n", exactRate / 1e6, exactBytes / 1e6);
+    printf("sketch + heap:  %6.2f M events/s, %7.1f MB\n", sketchRate / 1e6, trackerBytes(tracker) / 1e6);
+    printf("top-%d recall %.0f%%, mean relative error of reported counts %.3f%%\n",
+           k, 100.0 * recalled / k, 100 * relativeError / reported);
+    printf("mean overestimate per key: %.2f events (%.5f%% of the stream)\n",
+           overestimate / distinct, 100 * overestimate / distinct / n);
+    for (int i = 0; i < 5; i++) {
+        int count = get(exact, top[i].key, &found);
+        printf("  #%d %-10s estimate %u, exact %d\n", i + 1, top[i].key, top[i].count, count);
+    }
+
+    free(top);
+    freeHeavyHitters(tracker);
+    freeHashMap(exact);
+    free(stream);
+    for (int i = 0; i < numKeys; i++)
+        free(keys[i]);
+    free(keys);
+}
+
+// Example usage
+int main() {
+    HeavyHitters *tracker = createHeavyHitters(3, 64);
+    const char *events[] = {"apple", "banana", "apple", "cherry", "apple", "banana",
+                            "durian", "banana", "elder", "apple", "cherry", "fig"};
+    int numEvents = sizeof(events) / sizeof(events[0]);
+
+    printf("Streaming %d events...\n", numEvents);
+    for (int i = 0; i < numEvents; i++)
+        addEvent(tracker, events[i]);
+
+    HeapEntry top[3];
+    int count = topKeys(tracker, top);
+    printf("Top %d:\n", count);
+    for (int i = 0; i < count; i++)
+        printf("  %s: %u\n", top[i].key, top[i].count);
+
+    printf("Estimate for 'durian': %u\n", estimateCount(tracker, "durian"));
+    printf("Estimate for 'grape': %u\n", estimateCount(tracker, "grape"));
+    freeHeavyHitters(tracker);
+
+    printf("\n");
+    benchmark(1000000, 10000000, 100, 1 << 16);
+
+    return 0;
+}
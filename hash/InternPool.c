@@ -0,0 +1,544 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#define INITIAL_CAPACITY 16
+#define LOAD_FACTOR_THRESHOLD 0.75
+#define POOL_CHUNK_SIZE (64 * 1024)
+#define NO_ID UINT32_MAX
+
+// Interned strings are packed back to back in large chunks
+typedef struct StringChunk {
+    struct StringChunk *next;
+    char data[];
+} StringChunk;
+
+// A pool maps each distinct string to a dense 32-bit ID and keeps exactly one
+// immutable copy of it. Pools can be created per scope, or shared through
+// globalInternPool().
+typedef struct InternPool {
+    char **strings;         // strings[id]: canonical copy, valid until the pool is freed
+    uint64_t *hashes;       // hashes[id]
+    uint32_t count;
+    uint32_t idCapacity;
+    uint32_t *index;        // Open addressing over IDs: id + 1, 0 marks an empty slot
+    uint32_t indexCapacity; // Power of two
+    StringChunk *chunks;
+    char *cursor;
+    size_t remaining;
+    size_t stringBytes;
+} InternPool;
+
+// Map from interned keys to int values. Slots hold a 4-byte ID instead of a
+// key copy, and keys are equal exactly when their IDs are.
+typedef struct InternedHashMap {
+    InternPool *pool;
+    uint32_t *ids;          // id + 1, 0 marks an empty slot
+    int *values;
+    int capacity;           // Power of two
+    int size;
+} InternedHashMap;
+
+// 64x64 -> 128-bit multiply folded back to 64 bits
+static inline uint64_t mulFold(uint64_t a, uint64_t b) {
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+// wyhash-style hash, same as HashMap.c's default
+uint64_t hash(const char *key, size_t length) {
+    uint64_t hashValue = 0xa0761d6478bd642fULL;
+    uint64_t word;
+
+    while (length >= 8) {
+        memcpy(&word, key, 8);
+        hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL);
+        key += 8;
+        length -= 8;
+    }
+
+    word = 0;
+    memcpy(&word, key, length);
+    hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL ^ length);
+    return mulFold(hashValue, 0x8ebc6af09c88c6e3ULL);
+}
+
+// ---------------------------------------------------------------------------
+// Intern pool
+// ---------------------------------------------------------------------------
+
+InternPool* createInternPool() {
+    InternPool *pool = (InternPool*)calloc(1, sizeof(InternPool));
+    pool->idCapacity = INITIAL_CAPACITY;
+    pool->strings = (char**)malloc(pool->idCapacity * sizeof(char*));
+    pool->hashes = (uint64_t*)malloc(pool->idCapacity * sizeof(uint64_t));
+    pool->indexCapacity = INITIAL_CAPACITY;
+    pool->index = (uint32_t*)calloc(pool->indexCapacity, sizeof(uint32_t));
+    return pool;
+}
+
+// Process-wide pool for maps that don't need a scoped one
+InternPool* globalInternPool() {
+    static InternPool *pool = NULL;
+    if (pool == NULL)
+        pool = createInternPool();
+    return pool;
+}
+
+// Copy length bytes plus a terminator into chunk storage
+char* storeString(InternPool *pool, const char *string, size_t length) {
+    if (length + 1 > pool->remaining) {
+        size_t size = length + 1 > POOL_CHUNK_SIZE ? length + 1 : POOL_CHUNK_SIZE;
+        StringChunk *chunk = (StringChunk*)malloc(sizeof(StringChunk) + size);
+        chunk->next = pool->chunks;
+        pool->chunks = chunk;
+        pool->cursor = chunk->data;
+        pool->remaining = size;
+    }
+
+    char *copy = pool->cursor;
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+    pool->cursor += length + 1;
+    pool->remaining -= length + 1;
+    pool->stringBytes += length + 1;
+    return copy;
+}
+
+// Index slot holding string, or the empty slot where its ID would go
+uint32_t findIndexSlot(InternPool *pool, const char *string, size_t length, uint64_t hashValue) {
+    uint32_t mask = pool->indexCapacity - 1;
+    uint32_t slot = (uint32_t)hashValue & mask;
+
+    while (pool->index[slot] != 0) {
+        uint32_t id = pool->index[slot] - 1;
+        if (pool->hashes[id] == hashValue && strncmp(pool->strings[id], string, length) == 0 &&
+            pool->strings[id][length] == '\0')
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+// Double the index; IDs and strings never move
+void growIndex(InternPool *pool) {
+    uint32_t *oldIndex = pool->index;
+    uint32_t oldCapacity = pool->indexCapacity;
+
+    pool->indexCapacity *= 2;
+    pool->index = (uint32_t*)calloc(pool->indexCapacity, sizeof(uint32_t));
+    uint32_t mask = pool->indexCapacity - 1;
+
+    for (uint32_t i = 0; i < oldCapacity; i++) {
+        if (oldIndex[i] != 0) {
+            uint32_t slot = (uint32_t)pool->hashes[oldIndex[i] - 1] & mask;
+            while (pool->index[slot] != 0)
+                slot = (slot + 1) & mask;
+            pool->index[slot] = oldIndex[i];
+        }
+    }
+
+    free(oldIndex);
+}
+
+// ID of string, adding it to the pool if it is new
+uint32_t intern(InternPool *pool, const char *string) {
+    size_t length = strlen(string);
+    uint64_t hashValue = hash(string, length);
+    uint32_t slot = findIndexSlot(pool, string, length, hashValue);
+    if (pool->index[slot] != 0)
+        return pool->index[slot] - 1;
+
+    if (pool->count == pool->idCapacity) {
+        pool->idCapacity *= 2;
+        pool->strings = (char**)realloc(pool->strings, pool->idCapacity * sizeof(char*));
+        pool->hashes = (uint64_t*)realloc(pool->hashes, pool->idCapacity * sizeof(uint64_t));
+    }
+
+    uint32_t id = pool->count++;
+    pool->strings[id] = storeString(pool, string, length);
+    pool->hashes[id] = hashValue;
+    pool->index[slot] = id + 1;
+
+    if (pool->count >= pool->indexCapacity * LOAD_FACTOR_THRESHOLD)
+        growIndex(pool);
+
+    return id;
+}
+
+// ID of string if it was interned before, NO_ID otherwise (never adds)
+uint32_t lookupId(InternPool *pool, const char *string) {
+    size_t length = strlen(string);
+    uint32_t slot = findIndexSlot(pool, string, length, hash(string, length));
+    return pool->index[slot] != 0 ? pool->index[slot] - 1 : NO_ID;
+}
+
+// Canonical string for an ID
+const char* internedString(InternPool *pool, uint32_t id) {
+    return pool->strings[id];
+}
+
+// Bytes held by the pool: string storage, per-ID arrays and the index
+size_t internPoolBytes(InternPool *pool) {
+    return pool->stringBytes + pool->idCapacity * (sizeof(char*) + sizeof(uint64_t)) +
+           pool->indexCapacity * sizeof(uint32_t);
+}
+
+void freeInternPool(InternPool *pool) {
+    StringChunk *chunk = pool->chunks;
+    while (chunk != NULL) {
+        StringChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(pool->strings);
+    free(pool->hashes);
+    free(pool->index);
+    free(pool);
+}
+
+// ---------------------------------------------------------------------------
+// Hash map keyed by interned IDs
+// ---------------------------------------------------------------------------
+
+// Initialize hash map whose keys live in pool
+InternedHashMap* createHashMap(InternPool *pool) {
+    InternedHashMap *map = (InternedHashMap*)malloc(sizeof(InternedHashMap));
+    map->pool = pool;
+    map->capacity = INITIAL_CAPACITY;
+    map->size = 0;
+    map->ids = (uint32_t*)calloc(map->capacity, sizeof(uint32_t));
+    map->values = (int*)malloc(map->capacity * sizeof(int));
+    return map;
+}
+
+// Integer mix of an ID; no need to touch the pool or the string
+static inline int idSlot(InternedHashMap *map, uint32_t id) {
+    return (int)(mulFold(id + 1, 0x9e3779b97f4a7c15ULL) & (map->capacity - 1));
+}
+
+// Slot holding id, or the empty slot where it would go
+int findSlot(InternedHashMap *map, uint32_t id) {
+    int mask = map->capacity - 1;
+    int slot = idSlot(map, id);
+
+    while (map->ids[slot] != 0 && map->ids[slot] != id + 1)
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+// Double the slot arrays and move every ID to its first free slot
+void resize(InternedHashMap *map) {
+    uint32_t *oldIds = map->ids;
+    int *oldValues = map->values;
+    int oldCapacity = map->capacity;
+
+    map->capacity *= 2;
+    map->ids = (uint32_t*)calloc(map->capacity, sizeof(uint32_t));
+    map->values = (int*)malloc(map->capacity * sizeof(int));
+
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldIds[i] != 0) {
+            int slot = findSlot(map, oldIds[i] - 1);
+            map->ids[slot] = oldIds[i];
+            map->values[slot] = oldValues[i];
+        }
+    }
+
+    free(oldIds);
+    free(oldValues);
+}
+
+// Put a value for an interned key
+void putId(InternedHashMap *map, uint32_t id, int value) {
+    int slot = findSlot(map, id);
+    if (map->ids[slot] == 0) {
+        if (map->size + 1 > map->capacity * LOAD_FACTOR_THRESHOLD) {
+            resize(map);
+            slot = findSlot(map, id);
+        }
+        map->ids[slot] = id + 1;
+        map->size++;
+    }
+    map->values[slot] = value;
+}
+
+// Get value for an interned key
+int getId(InternedHashMap *map, uint32_t id, bool *found) {
+    int slot = findSlot(map, id);
+    *found = map->ids[slot] != 0;
+    return *found ? map->values[slot] : -1;
+}
+
+bool containsId(InternedHashMap *map, uint32_t id) {
+    return map->ids[findSlot(map, id)] != 0;
+}
+
+// Remove an interned key. Backward-shift deletion pulls later IDs of the probe
+// run into the hole, so no tombstones are needed.
+bool removeId(InternedHashMap *map, uint32_t id) {
+    int mask = map->capacity - 1;
+    int hole = findSlot(map, id);
+    if (map->ids[hole] == 0)
+        return false;
+
+    int slot = hole;
+    for (;;) {
+        slot = (slot + 1) & mask;
+        if (map->ids[slot] == 0)
+            break;
+
+        // An ID may move back only if its home is not inside (hole, slot]
+        int home = idSlot(map, map->ids[slot] - 1);
+        bool homeInRange = hole <= slot ? (hole < home && home <= slot)
+                                        : (hole < home || home <= slot);
+        if (!homeInRange) {
+            map->ids[hole] = map->ids[slot];
+            map->values[hole] = map->values[slot];
+            hole = slot;
+        }
+    }
+
+    map->ids[hole] = 0;
+    map->size--;
+    return true;
+}
+
+// String-keyed wrappers: put interns the key, the others only look it up, so
+// probing for absent strings never grows the pool
+void put(InternedHashMap *map, const char *key, int value) {
+    putId(map, intern(map->pool, key), value);
+}
+
+int get(InternedHashMap *map, const char *key, bool *found) {
+    uint32_t id = lookupId(map->pool, key);
+    if (id == NO_ID) {
+        *found = false;
+        return -1;
+    }
+    return getId(map, id, found);
+}
+
+bool containsKey(InternedHashMap *map, const char *key) {
+    uint32_t id = lookupId(map->pool, key);
+    return id != NO_ID && containsId(map, id);
+}
+
+bool removeKey(InternedHashMap *map, const char *key) {
+    uint32_t id = lookupId(map->pool, key);
+    return id != NO_ID && removeId(map, id);
+}
+
+// Check if map is empty
+bool isEmpty(InternedHashMap *map) {
+    return map->size == 0;
+}
+
+// Get size of map
+int getSize(InternedHashMap *map) {
+    return map->size;
+}
+
+// Bytes held by the map itself (the pool is shared and counted separately)
+size_t mapBytes(InternedHashMap *map) {
+    return sizeof(InternedHashMap) + map->capacity * (sizeof(uint32_t) + sizeof(int));
+}
+
+// Print the hash map
+void printHashMap(InternedHashMap *map) {
+    printf("InternedHashMap (size: %d, capacity: %d):\n", map->size, map->capacity);
+    for (int i = 0; i < map->capacity; i++) {
+        if (map->ids[i] != 0)
+            printf("Slot %d: [#%u %s: %d]\n", i, map->ids[i] - 1,
+                   internedString(map->pool, map->ids[i] - 1), map->values[i]);
+    }
+}
+
+// Free the hash map (not the pool)
+void freeHashMap(InternedHashMap *map) {
+    free(map->ids);
+    free(map->values);
+    free(map);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark against per-map key copies, as in HashMap.c
+// ---------------------------------------------------------------------------
+
+typedef struct CopiedEntry {
+    uint64_t hash;
+    char *key;
+    int value;
+    struct CopiedEntry *next;
+} CopiedEntry;
+
+typedef struct CopiedMap {
+    CopiedEntry **buckets;
+    int capacity;
+    size_t bytes;
+} CopiedMap;
+
+void copiedPut(CopiedMap *map, const char *key, int value) {
+    size_t length = strlen(key);
+    uint64_t hashValue = hash(key, length);
+    CopiedEntry *entry = (CopiedEntry*)malloc(sizeof(CopiedEntry));
+    entry->hash = hashValue;
+    entry->key = (char*)malloc(length + 1);
+    strcpy(entry->key, key);
+    entry->value = value;
+    entry->next = map->buckets[hashValue & (map->capacity - 1)];
+    map->buckets[hashValue & (map->capacity - 1)] = entry;
+    map->bytes += sizeof(CopiedEntry) + length + 1;
+}
+
+int copiedGet(CopiedMap *map, const char *key) {
+    uint64_t hashValue = hash(key, strlen(key));
+    for (CopiedEntry *entry = map->buckets[hashValue & (map->capacity - 1)]; entry != NULL; entry = entry->next) {
+        if (entry->hash == hashValue && strcmp(entry->key, key) == 0)
+            return entry->value;
+    }
+    return -1;
+}
+
+void freeCopiedMap(CopiedMap *map) {
+    for (int i = 0; i < map->capacity; i++) {
+        CopiedEntry *entry = map->buckets[i];
+        while (entry != NULL) {
+            CopiedEntry *next = entry->next;
+            free(entry->key);
+            free(entry);
+            entry = next;
+        }
+    }
+    free(map->buckets);
+}
+
+double elapsedNs(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+// numMaps maps over the same vocabulary of numKeys keys. Memory is counted from
+// the structures (malloc headers excluded, which only favours the copies).
+// Lookups resolve each key once and then query every map, e.g. one record's
+// fields checked against several per-tenant tables.
+void benchmark(int numMaps, int numKeys) {
+    char **keys = (char**)malloc(numKeys * sizeof(char*));
+    for (int i = 0; i < numKeys; i++) {
+        keys[i] = (char*)malloc(48);
+        sprintf(keys[i], "customer:%d:billing-region", i);
+    }
+
+    int capacity = INITIAL_CAPACITY;
+    while (numKeys >= capacity * LOAD_FACTOR_THRESHOLD)
+        capacity *= 2;
+
+    CopiedMap *copied = (CopiedMap*)malloc(numMaps * sizeof(CopiedMap));
+    size_t copiedBytes = 0;
+    for (int m = 0; m < numMaps; m++) {
+        copied[m].capacity = capacity;
+        copied[m].bytes = capacity * sizeof(CopiedEntry*);
+        copied[m].buckets = (CopiedEntry**)calloc(capacity, sizeof(CopiedEntry*));
+        for (int i = 0; i < numKeys; i++)
+            copiedPut(&copied[m], keys[i], i + m);
+        copiedBytes += copied[m].bytes;
+    }
+
+    InternPool *pool = createInternPool();
+    InternedHashMap **interned = (InternedHashMap**)malloc(numMaps * sizeof(InternedHashMap*));
+    size_t internedBytes = 0;
+    for (int m = 0; m < numMaps; m++) {
+        interned[m] = createHashMap(pool);
+        for (int i = 0; i < numKeys; i++)
+            put(interned[m], keys[i], i + m);
+        internedBytes += mapBytes(interned[m]);
+    }
+    internedBytes += internPoolBytes(pool);
+
+    struct timespec start, end;
+    long sum = 0;
+    bool found;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < numKeys; i++)
+        for (int m = 0; m < numMaps; m++)
+            sum += copiedGet(&copied[m], keys[(int)((uint64_t)i * 2654435761u % numKeys)]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double copiedNs = elapsedNs(start, end) / ((double)numKeys * numMaps);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < numKeys; i++) {
+        uint32_t id = lookupId(pool, keys[(int)((uint64_t)i * 2654435761u % numKeys)]);
+        for (int m = 0; m < numMaps; m++)
+            sum += getId(interned[m], id, &found);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double internedNs = elapsedNs(start, end) / ((double)numKeys * numMaps);
+
+    printf("%d maps x %d shared keys:\n", numMaps, numKeys);
+    printf("per-map copies: %7.1f MB, %5.1f ns per map lookup\n", copiedBytes / 1e6, copiedNs);
+    printf("intern pool:    %7.1f MB, %5.1f ns per map lookup (checksum %ld)\n",
+           internedBytes / 1e6, internedNs, sum);
+
+    for (int m = 0; m < numMaps; m++) {
+        freeCopiedMap(&copied[m]);
+        freeHashMap(interned[m]);
+    }
+    free(copied);
+    free(interned);
+    freeInternPool(pool);
+    for (int i = 0; i < numKeys; i++)
+        free(keys[i]);
+    free(keys);
+}
+
+// Example usage
+int main() {
+    InternPool *pool = createInternPool();
+    InternedHashMap *prices = createHashMap(pool);
+    InternedHashMap *stock = createHashMap(pool);
+
+    // Both maps share one copy of each key
+    printf("Inserting elements...\n");
+    put(prices, "apple", 100);
+    put(prices, "banana", 200);
+    put(prices, "orange", 300);
+    put(stock, "banana", 7);
+    put(stock, "apple", 12);
+
+    printHashMap(prices);
+    printHashMap(stock);
+
+    uint32_t apple = lookupId(pool, "apple");
+    printf("\n'apple' is #%u in both maps; pool holds %u strings\n", apple, pool->count);
+    printf("Same pointer: %s\n", internedString(pool, intern(pool, "apple")) == internedString(pool, apple) ? "yes" : "no");
+
+    // Get values, by string or by ID
+    printf("\nGetting values:\n");
+    bool found;
+    int value = get(prices, "banana", &found);
+    printf("banana price: %s (value: %d)\n", found ? "found" : "not found", value);
+    value = getId(stock, apple, &found);
+    printf("apple stock: %d\n", value);
+    printf("Contains key 'cherry': %s (pool still holds %u strings)\n",
+           containsKey(prices, "cherry") ? "yes" : "no", pool->count);
+
+    // Remove a key
+    printf("\nRemoving 'banana' from prices...\n");
+    removeKey(prices, "banana");
+    printf("Size after removal: %d, stock still has banana: %s\n",
+           getSize(prices), containsKey(stock, "banana") ? "yes" : "no");
+
+    freeHashMap(prices);
+    freeHashMap(stock);
+    freeInternPool(pool);
+
+    printf("\n");
+    benchmark(16, 100000);
+
+    return 0;
+}
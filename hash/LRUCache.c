@@ -0,0 +1,520 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#define CACHE_LOAD_FACTOR 0.75      // Bucket count is fixed at capacity / 0.75
+#define PROTECTED_SHARE 0.8         // SLRU: fraction of the capacity kept for re-used keys
+#define SKETCH_DEPTH 4
+#define SKETCH_MAX_COUNT 15         // 4-bit saturating counters
+#define SKETCH_SAMPLE_FACTOR 10     // Halve all counters every 10 * capacity accesses
+
+typedef enum CachePolicy {
+    CACHE_LRU,          // Single recency list, evict the least recently used
+    CACHE_SLRU,         // Probation + protected segments: one-hit keys can't flush re-used ones
+    CACHE_TINYLFU,      // SLRU, and a new key only replaces a victim it is more frequent than
+    CACHE_POLICY_COUNT
+} CachePolicy;
+
+typedef enum Segment {
+    SEGMENT_PROBATION,
+    SEGMENT_PROTECTED
+} Segment;
+
+// Same shape as the list node in linked-list/doubly_linked_list.c, plus the
+// fields that let the node sit in the hash index too (intrusive: one
+// allocation per cached key, and unlinking from either structure is O(1))
+typedef struct Node {
+    int value;
+    struct Node *next;
+    struct Node *prev;
+    struct Node *chain;     // Next node in the same hash bucket
+    uint64_t hash;
+    Segment segment;
+    char *key;
+} Node;
+
+typedef struct {
+    Node *head;     // Most recently used
+    Node *tail;     // Least recently used
+    int size;
+} DoublyLinkedList;
+
+// Count-min sketch of recent access frequencies, aged by periodic halving
+typedef struct FrequencySketch {
+    uint8_t *counters;      // SKETCH_DEPTH rows of width counters
+    int width;              // Power of two
+    int additions;
+    int sampleSize;
+} FrequencySketch;
+
+typedef struct LRUCache {
+    Node **buckets;
+    int numBuckets;             // Power of two, never resized
+    DoublyLinkedList probation; // The only list under CACHE_LRU
+    DoublyLinkedList protectedList;
+    int capacity;
+    int protectedCapacity;
+    int size;
+    CachePolicy policy;
+    FrequencySketch *sketch;    // CACHE_TINYLFU only
+    long hits;
+    long misses;
+    long evictions;
+    long rejections;            // Keys TinyLFU refused to admit
+} LRUCache;
+
+const char *policyNames[CACHE_POLICY_COUNT] = {"LRU", "SLRU", "TinyLFU"};
+
+// 64x64 -> 128-bit multiply folded back to 64 bits
+static inline uint64_t mulFold(uint64_t a, uint64_t b) {
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+// wyhash-style hash, same as HashMap.c's default
+uint64_t hash(const char *key) {
+    size_t length = strlen(key);
+    uint64_t hashValue = 0xa0761d6478bd642fULL;
+    uint64_t word;
+
+    while (length >= 8) {
+        memcpy(&word, key, 8);
+        hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL);
+        key += 8;
+        length -= 8;
+    }
+
+    word = 0;
+    memcpy(&word, key, length);
+    hashValue = mulFold(hashValue ^ word, 0xe7037ed1a0b428dbULL ^ length);
+    return mulFold(hashValue, 0x8ebc6af09c88c6e3ULL);
+}
+
+// ---------------------------------------------------------------------------
+// Recency lists
+// ---------------------------------------------------------------------------
+
+void pushFront(DoublyLinkedList *list, Node *node) {
+    node->prev = NULL;
+    node->next = list->head;
+
+    if (list->head == NULL)
+        list->tail = node;
+    else
+        list->head->prev = node;
+
+    list->head = node;
+    list->size++;
+}
+
+void unlinkNode(DoublyLinkedList *list, Node *node) {
+    if (node->prev == NULL)
+        list->head = node->next;
+    else
+        node->prev->next = node->next;
+
+    if (node->next == NULL)
+        list->tail = node->prev;
+    else
+        node->next->prev = node->prev;
+
+    list->size--;
+}
+
+// ---------------------------------------------------------------------------
+// Frequency sketch
+// ---------------------------------------------------------------------------
+
+FrequencySketch* createSketch(int capacity) {
+    FrequencySketch *sketch = (FrequencySketch*)malloc(sizeof(FrequencySketch));
+    sketch->width = 16;
+    while (sketch->width < capacity)
+        sketch->width *= 2;
+    sketch->counters = (uint8_t*)calloc((size_t)SKETCH_DEPTH * sketch->width, 1);
+    sketch->additions = 0;
+    sketch->sampleSize = SKETCH_SAMPLE_FACTOR * capacity;
+    return sketch;
+}
+
+// Counter of a hash in one row. Each row remixes the hash with its own
+// multiplier, as in HeavyHitters.c, so keys colliding in one row rarely
+// collide in the others.
+static inline uint8_t* sketchCounter(FrequencySketch *sketch, uint64_t hashValue, int row) {
+    static const uint64_t rowSeeds[SKETCH_DEPTH] = {
+        0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL, 0x165667b19e3779f9ULL, 0xd6e8feb86659fd93ULL
+    };
+    uint64_t index = mulFold(hashValue, rowSeeds[row]) & (sketch->width - 1);
+    return &sketch->counters[(size_t)row * sketch->width + index];
+}
+
+void sketchIncrement(FrequencySketch *sketch, uint64_t hashValue) {
+    for (int row = 0; row < SKETCH_DEPTH; row++) {
+        uint8_t *counter = sketchCounter(sketch, hashValue, row);
+        if (*counter < SKETCH_MAX_COUNT)
+            (*counter)++;
+    }
+
+    // Aging: old popularity fades so the sketch follows a shifting workload
+    if (++sketch->additions == sketch->sampleSize) {
+        for (size_t i = 0; i < (size_t)SKETCH_DEPTH * sketch->width; i++)
+            sketch->counters[i] >>= 1;
+        sketch->additions /= 2;
+    }
+}
+
+int sketchEstimate(FrequencySketch *sketch, uint64_t hashValue) {
+    int estimate = SKETCH_MAX_COUNT;
+    for (int row = 0; row < SKETCH_DEPTH; row++) {
+        int count = *sketchCounter(sketch, hashValue, row);
+        if (count < estimate)
+            estimate = count;
+    }
+    return estimate;
+}
+
+// ---------------------------------------------------------------------------
+// Cache
+// ---------------------------------------------------------------------------
+
+// Initialize a cache that holds at most capacity keys; NULL unless capacity >= 1
+LRUCache* createCache(int capacity, CachePolicy policy) {
+    if (capacity < 1)
+        return NULL;
+
+    LRUCache *cache = (LRUCache*)calloc(1, sizeof(LRUCache));
+    cache->capacity = capacity;
+    cache->policy = policy;
+    cache->protectedCapacity = policy == CACHE_LRU ? 0 : (int)(capacity * PROTECTED_SHARE);
+
+    cache->numBuckets = 16;
+    while (cache->numBuckets * CACHE_LOAD_FACTOR < capacity)
+        cache->numBuckets *= 2;
+    cache->buckets = (Node**)calloc(cache->numBuckets, sizeof(Node*));
+
+    if (policy == CACHE_TINYLFU)
+        cache->sketch = createSketch(capacity);
+
+    return cache;
+}
+
+Node** bucketFor(LRUCache *cache, uint64_t hashValue) {
+    return &cache->buckets[hashValue & (cache->numBuckets - 1)];
+}
+
+Node* findNode(LRUCache *cache, const char *key, uint64_t hashValue) {
+    for (Node *node = *bucketFor(cache, hashValue); node != NULL; node = node->chain) {
+        if (node->hash == hashValue && strcmp(node->key, key) == 0)
+            return node;
+    }
+    return NULL;
+}
+
+void unlinkFromBucket(LRUCache *cache, Node *node) {
+    Node **link = bucketFor(cache, node->hash);
+    while (*link != node)
+        link = &(*link)->chain;
+    *link = node->chain;
+}
+
+DoublyLinkedList* listOf(LRUCache *cache, Node *node) {
+    return node->segment == SEGMENT_PROTECTED ? &cache->protectedList : &cache->probation;
+}
+
+// A hit: move to the front of its list. Under SLRU a second hit on a probation
+// key promotes it to protected, demoting protected's LRU key if that overflows.
+void promote(LRUCache *cache, Node *node) {
+    unlinkNode(listOf(cache, node), node);
+
+    if (cache->policy == CACHE_LRU || node->segment == SEGMENT_PROTECTED) {
+        pushFront(listOf(cache, node), node);
+        return;
+    }
+
+    node->segment = SEGMENT_PROTECTED;
+    pushFront(&cache->protectedList, node);
+
+    if (cache->protectedList.size > cache->protectedCapacity) {
+        Node *demoted = cache->protectedList.tail;
+        unlinkNode(&cache->protectedList, demoted);
+        demoted->segment = SEGMENT_PROBATION;
+        pushFront(&cache->probation, demoted);
+    }
+}
+
+// Next key to evict: probation's LRU end, or protected's if probation is empty
+Node* victimOf(LRUCache *cache) {
+    return cache->probation.tail != NULL ? cache->probation.tail : cache->protectedList.tail;
+}
+
+// Get value for a key and mark it recently used
+int cacheGet(LRUCache *cache, const char *key, bool *found) {
+    uint64_t hashValue = hash(key);
+    if (cache->sketch != NULL)
+        sketchIncrement(cache->sketch, hashValue);
+
+    Node *node = findNode(cache, key, hashValue);
+    if (node == NULL) {
+        cache->misses++;
+        *found = false;
+        return -1;
+    }
+
+    cache->hits++;
+    promote(cache, node);
+    *found = true;
+    return node->value;
+}
+
+// Insert or update a key. When the cache is full the policy's victim is
+// evicted, except that TinyLFU keeps the victim instead if it has been used
+// at least as often as the new key.
+void cachePut(LRUCache *cache, const char *key, int value) {
+    uint64_t hashValue = hash(key);
+
+    Node *node = findNode(cache, key, hashValue);
+    if (node != NULL) {
+        node->value = value;
+        promote(cache, node);
+        return;
+    }
+
+    if (cache->size == cache->capacity) {
+        node = victimOf(cache);
+
+        if (cache->sketch != NULL &&
+            sketchEstimate(cache->sketch, hashValue) <= sketchEstimate(cache->sketch, node->hash)) {
+            cache->rejections++;
+            return;
+        }
+
+        // Recycle the victim's node for the new key
+        unlinkNode(listOf(cache, node), node);
+        unlinkFromBucket(cache, node);
+        free(node->key);
+        cache->evictions++;
+        cache->size--;
+    } else {
+        node = (Node*)malloc(sizeof(Node));
+    }
+
+    node->value = value;
+    node->hash = hashValue;
+    node->segment = SEGMENT_PROBATION;
+    node->key = (char*)malloc(strlen(key) + 1);
+    strcpy(node->key, key);
+
+    Node **bucket = bucketFor(cache, hashValue);
+    node->chain = *bucket;
+    *bucket = node;
+    pushFront(&cache->probation, node);
+    cache->size++;
+}
+
+// Remove a key
+bool cacheRemove(LRUCache *cache, const char *key) {
+    Node *node = findNode(cache, key, hash(key));
+    if (node == NULL)
+        return false;
+
+    unlinkNode(listOf(cache, node), node);
+    unlinkFromBucket(cache, node);
+    free(node->key);
+    free(node);
+    cache->size--;
+    return true;
+}
+
+// Fraction of cacheGet() calls that hit
+double hitRatio(LRUCache *cache) {
+    long lookups = cache->hits + cache->misses;
+    return lookups == 0 ? 0.0 : (double)cache->hits / lookups;
+}
+
+void printList(const char *label, DoublyLinkedList *list) {
+    printf("%s (%d): ", label, list->size);
+    for (Node *node = list->head; node != NULL; node = node->next)
+        printf("[%s: %d] ", node->key, node->value);
+    printf("\n");
+}
+
+// Print keys from most to least recently used
+void printCache(LRUCache *cache) {
+    printf("%s cache (size: %d, capacity: %d):\n", policyNames[cache->policy], cache->size, cache->capacity);
+    if (cache->policy != CACHE_LRU)
+        printList("Protected", &cache->protectedList);
+    printList(cache->policy == CACHE_LRU ? "Recency" : "Probation", &cache->probation);
+}
+
+void freeList(DoublyLinkedList *list) {
+    Node *current = list->head;
+    while (current != NULL) {
+        Node *next = current->next;
+        free(current->key);
+        free(current);
+        current = next;
+    }
+}
+
+// Free the cache
+void freeCache(LRUCache *cache) {
+    freeList(&cache->probation);
+    freeList(&cache->protectedList);
+    if (cache->sketch != NULL) {
+        free(cache->sketch->counters);
+        free(cache->sketch);
+    }
+    free(cache->buckets);
+    free(cache);
+}
+
+// ---------------------------------------------------------------------------
+// Trace replay
+// ---------------------------------------------------------------------------
+
+// Read-through replay: every access is a cacheGet(), and a miss loads the key
+// with cachePut(). trace holds indices into keys.
+void replayTrace(char **keys, const int *trace, int n, int capacity, CachePolicy policy) {
+    LRUCache *cache = createCache(capacity, policy);
+    struct timespec start, end;
+    bool found;
+    long checksum = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) {
+        const char *key = keys[trace[i]];
+        checksum += cacheGet(cache, key, &found);
+        if (!found)
+            cachePut(cache, key, trace[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("  %-8s hit ratio %6.2f%%  %6.2f Mops/s  (evictions %ld, rejected %ld, checksum %ld)\n",
+           policyNames[policy], 100 * hitRatio(cache), n / seconds / 1e6,
+           cache->evictions, cache->rejections, checksum);
+    freeCache(cache);
+}
+
+// Zipf(s) sampler over numKeys ranks via the cumulative distribution
+int* zipfTrace(int numKeys, int n, double s, unsigned int seed) {
+    double *cdf = (double*)malloc(numKeys * sizeof(double));
+    double total = 0;
+    for (int k = 0; k < numKeys; k++) {
+        total += 1.0 / pow(k + 1, s);
+        cdf[k] = total;
+    }
+
+    int *trace = (int*)malloc(n * sizeof(int));
+    srand(seed);
+    for (int i = 0; i < n; i++) {
+        double u = (double)rand() / ((double)RAND_MAX + 1) * total;
+        int low = 0, high = numKeys - 1;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (cdf[mid] < u)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        // Scatter ranks so popular keys aren't all "key0".."key9"
+        trace[i] = (int)(((uint64_t)low * 2654435761u) % numKeys);
+    }
+
+    free(cdf);
+    return trace;
+}
+
+void runTraces(int capacity) {
+    const int numKeys = 100000;
+    const int scanKeys = 200000;
+    const int n = 2000000;
+
+    // Key table: popular keys first, then one-off keys used by scans
+    char **keys = (char**)malloc((numKeys + scanKeys) * sizeof(char*));
+    for (int i = 0; i < numKeys + scanKeys; i++) {
+        keys[i] = (char*)malloc(24);
+        sprintf(keys[i], i < numKeys ? "user:%d" : "scan:%d", i);
+    }
+
+    int *zipf = zipfTrace(numKeys, n, 0.9, 42);
+    printf("\nZipf(0.9) over %d keys, %d accesses, capacity %d:\n", numKeys, n, capacity);
+    for (int policy = 0; policy < CACHE_POLICY_COUNT; policy++)
+        replayTrace(keys, zipf, n, capacity, (CachePolicy)policy);
+
+    // Same workload, with a one-pass scan of 20k never-repeated keys every 200k accesses
+    int *scanned = (int*)malloc(n * sizeof(int));
+    int next = numKeys;
+    for (int i = 0; i < n; i++) {
+        if (i % 200000 < 20000)
+            scanned[i] = next++;
+        else
+            scanned[i] = zipf[i];
+    }
+    printf("Zipf(0.9) with periodic scans:\n");
+    for (int policy = 0; policy < CACHE_POLICY_COUNT; policy++)
+        replayTrace(keys, scanned, n, capacity, (CachePolicy)policy);
+
+    // A loop slightly larger than the cache: pure LRU always evicts the next key
+    int loopSize = capacity + capacity / 5;
+    for (int i = 0; i < n; i++)
+        scanned[i] = i % loopSize;
+    printf("Loop over %d keys:\n", loopSize);
+    for (int policy = 0; policy < CACHE_POLICY_COUNT; policy++)
+        replayTrace(keys, scanned, n, capacity, (CachePolicy)policy);
+
+    free(zipf);
+    free(scanned);
+    for (int i = 0; i < numKeys + scanKeys; i++)
+        free(keys[i]);
+    free(keys);
+}
+
+// Example usage
+int main() {
+    LRUCache *cache = createCache(3, CACHE_LRU);
+
+    printf("Putting a, b, c into an LRU cache of capacity 3...\n");
+    cachePut(cache, "a", 1);
+    cachePut(cache, "b", 2);
+    cachePut(cache, "c", 3);
+    printCache(cache);
+
+    bool found;
+    int value = cacheGet(cache, "a", &found);
+    printf("\nget(a): %d\n", value);
+    printCache(cache);
+
+    printf("\nPutting d evicts the least recently used key (b)...\n");
+    cachePut(cache, "d", 4);
+    printCache(cache);
+    cacheGet(cache, "b", &found);
+    printf("get(b): %s\n", found ? "found" : "not found");
+    printf("Hit ratio: %.2f\n", hitRatio(cache));
+    freeCache(cache);
+
+    printf("\nSegmented LRU of capacity 5 (4 protected slots):\n");
+    cache = createCache(5, CACHE_SLRU);
+    cachePut(cache, "a", 1);
+    cachePut(cache, "b", 2);
+    cachePut(cache, "c", 3);
+    cacheGet(cache, "a", &found);
+    cacheGet(cache, "b", &found);
+    printCache(cache);
+
+    printf("\nA scan of one-off keys only cycles through probation...\n");
+    for (int i = 0; i < 10; i++) {
+        char key[20];
+        sprintf(key, "scan%d", i);
+        cachePut(cache, key, i);
+    }
+    printCache(cache);
+    freeCache(cache);
+
+    runTraces(10000);
+
+    return 0;
+}
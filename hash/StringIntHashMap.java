@@ -0,0 +1,301 @@
+// String -> int map with open addressing over parallel arrays: no Entry objects,
+// no boxed Integer values. Slot i holds keys[i], values[i] and the cached hash
+// of the key in hashes[i]; keys[i] == null marks an empty slot.
+public class StringIntHashMap {
+    private static final int INITIAL_CAPACITY = 16;
+    private static final double LOAD_FACTOR_THRESHOLD = 0.75;
+    
+    private String[] keys;
+    private int[] values;
+    private int[] hashes;
+    private int capacity;
+    private int size;
+    
+    public StringIntHashMap() {
+        this(INITIAL_CAPACITY);
+    }
+    
+    // Presize for expectedSize keys so loading them never resizes
+    public StringIntHashMap(int expectedSize) {
+        this.capacity = INITIAL_CAPACITY;
+        while (expectedSize >= capacity * LOAD_FACTOR_THRESHOLD) {
+            capacity *= 2;
+        }
+        this.size = 0;
+        this.keys = new String[capacity];
+        this.values = new int[capacity];
+        this.hashes = new int[capacity];
+    }
+    
+    // Hash function: spread the high bits into the low ones
+    private static int hash(String key) {
+        int hashValue = key.hashCode();
+        hashValue ^= hashValue >>> 16;
+        hashValue *= 0x85ebca6b;
+        hashValue ^= hashValue >>> 13;
+        return hashValue;
+    }
+    
+    // Slot holding key, or the empty slot where it would go. Comparing the
+    // cached hashes first skips equals() for almost every other key on the way.
+    private int findSlot(String key, int hashValue) {
+        int mask = capacity - 1;
+        int index = hashValue & mask;
+        
+        while (keys[index] != null) {
+            if (hashes[index] == hashValue && keys[index].equals(key)) {
+                return index;
+            }
+            index = (index + 1) & mask;
+        }
+        
+        return index;
+    }
+    
+    // Get load factor
+    private double getLoadFactor() {
+        return (double) size / capacity;
+    }
+    
+    // Double the arrays and move every key straight into its new slot. The
+    // cached hashes mean nothing is rehashed, and since all keys are distinct
+    // there is no lookup or load check per key: just probe to the first free slot.
+    private void resize() {
+        String[] oldKeys = keys;
+        int[] oldValues = values;
+        int[] oldHashes = hashes;
+        int oldCapacity = capacity;
+        
+        capacity *= 2;
+        keys = new String[capacity];
+        values = new int[capacity];
+        hashes = new int[capacity];
+        int mask = capacity - 1;
+        
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldKeys[i] != null) {
+                int index = oldHashes[i] & mask;
+                while (keys[index] != null) {
+                    index = (index + 1) & mask;
+                }
+                keys[index] = oldKeys[i];
+                values[index] = oldValues[i];
+                hashes[index] = oldHashes[i];
+            }
+        }
+    }
+    
+    // Put a key-value pair into the map
+    public void put(String key, int value) {
+        int hashValue = hash(key);
+        int index = findSlot(key, hashValue);
+        
+        // Update if key already exists
+        if (keys[index] != null) {
+            values[index] = value;
+            return;
+        }
+        
+        // Keep a quarter of the slots free so probe runs stay short
+        if (size + 1 > capacity * LOAD_FACTOR_THRESHOLD) {
+            resize();
+            index = findSlot(key, hashValue);
+        }
+        
+        keys[index] = key;
+        values[index] = value;
+        hashes[index] = hashValue;
+        size++;
+    }
+    
+    // Get value for a key, or defaultValue if it is not present
+    public int getOrDefault(String key, int defaultValue) {
+        int index = findSlot(key, hash(key));
+        return keys[index] != null ? values[index] : defaultValue;
+    }
+    
+    // Check if key exists
+    public boolean containsKey(String key) {
+        return keys[findSlot(key, hash(key))] != null;
+    }
+    
+    // Remove a key-value pair. Backward-shift deletion pulls later keys of the
+    // probe run into the hole, so no tombstones are needed.
+    public boolean remove(String key) {
+        int mask = capacity - 1;
+        int hole = findSlot(key, hash(key));
+        if (keys[hole] == null) {
+            return false;
+        }
+        
+        int index = hole;
+        while (true) {
+            index = (index + 1) & mask;
+            if (keys[index] == null) {
+                break;
+            }
+            
+            // A key may move back only if its home slot is not inside (hole, index]
+            int home = hashes[index] & mask;
+            boolean homeInRange = hole <= index ? (hole < home && home <= index)
+                                                : (hole < home || home <= index);
+            if (!homeInRange) {
+                keys[hole] = keys[index];
+                values[hole] = values[index];
+                hashes[hole] = hashes[index];
+                hole = index;
+            }
+        }
+        
+        keys[hole] = null;
+        size--;
+        return true;
+    }
+    
+    // Get all keys
+    public String[] getKeys() {
+        String[] result = new String[size];
+        int index = 0;
+        
+        for (int i = 0; i < capacity; i++) {
+            if (keys[i] != null) {
+                result[index++] = keys[i];
+            }
+        }
+        
+        return result;
+    }
+    
+    // Get all values
+    public int[] getValues() {
+        int[] result = new int[size];
+        int index = 0;
+        
+        for (int i = 0; i < capacity; i++) {
+            if (keys[i] != null) {
+                result[index++] = values[i];
+            }
+        }
+        
+        return result;
+    }
+    
+    // Clear all entries
+    public void clear() {
+        java.util.Arrays.fill(keys, null);
+        size = 0;
+    }
+    
+    // Check if map is empty
+    public boolean isEmpty() {
+        return size == 0;
+    }
+    
+    // Get size of map
+    public int size() {
+        return size;
+    }
+    
+    // Get capacity
+    public int capacity() {
+        return capacity;
+    }
+    
+    // Print the hash map
+    public void printHashMap() {
+        System.out.printf("StringIntHashMap (size: %d, capacity: %d, load factor: %.2f):%n",
+                         size, capacity, getLoadFactor());
+        
+        for (int i = 0; i < capacity; i++) {
+            if (keys[i] != null) {
+                System.out.println("Slot " + i + ": [" + keys[i] + ": " + values[i] + "]");
+            }
+        }
+    }
+    
+    // Load n keys and look each one up, against java.util.HashMap<String, Integer>
+    private static void benchmark(int n) {
+        String[] input = new String[n];
+        for (int i = 0; i < n; i++) {
+            input[i] = "key" + i;
+        }
+        
+        // Warm up both paths before timing
+        for (int round = 0; round < 3; round++) {
+            long start = System.nanoTime();
+            StringIntHashMap primitive = new StringIntHashMap();
+            for (int i = 0; i < n; i++) {
+                primitive.put(input[i], i);
+            }
+            long sum = 0;
+            for (int i = 0; i < n; i++) {
+                sum += primitive.getOrDefault(input[i], 0);
+            }
+            long primitiveNs = System.nanoTime() - start;
+            
+            start = System.nanoTime();
+            java.util.HashMap<String, Integer> boxed = new java.util.HashMap<>();
+            for (int i = 0; i < n; i++) {
+                boxed.put(input[i], i);
+            }
+            for (int i = 0; i < n; i++) {
+                sum += boxed.getOrDefault(input[i], 0);
+            }
+            long boxedNs = System.nanoTime() - start;
+            
+            System.out.printf("round %d: StringIntHashMap %.1f ns/key, java.util.HashMap %.1f ns/key (checksum %d)%n",
+                             round, (double) primitiveNs / n, (double) boxedNs / n, sum);
+        }
+    }
+    
+    // Example usage
+    public static void main(String[] args) {
+        StringIntHashMap map = new StringIntHashMap();
+        
+        // Insert key-value pairs
+        System.out.println("Inserting elements...");
+        map.put("apple", 100);
+        map.put("banana", 200);
+        map.put("orange", 300);
+        map.put("grape", 400);
+        map.put("mango", 500);
+        
+        map.printHashMap();
+        
+        // Get values, with a sentinel for missing keys instead of null
+        System.out.println("\nGetting values:");
+        System.out.println("banana: " + map.getOrDefault("banana", -1));
+        System.out.println("cherry: " + map.getOrDefault("cherry", -1));
+        
+        // Check if key exists
+        System.out.println("\nContains key 'apple': " + map.containsKey("apple"));
+        System.out.println("Contains key 'cherry': " + map.containsKey("cherry"));
+        
+        // Update value
+        System.out.println("\nUpdating 'apple' to 150...");
+        map.put("apple", 150);
+        System.out.println("apple: " + map.getOrDefault("apple", -1));
+        
+        // Remove a key
+        System.out.println("\nRemoving 'banana'...");
+        map.remove("banana");
+        System.out.println("Size after removal: " + map.size());
+        
+        // Test resizing by adding many elements
+        System.out.println("\nAdding more elements to trigger resize...");
+        for (int i = 0; i < 20; i++) {
+            map.put("key" + i, i * 10);
+        }
+        
+        map.printHashMap();
+        
+        // Clear the map
+        System.out.println("\nClearing map...");
+        map.clear();
+        System.out.println("Size after clear: " + map.size());
+        System.out.println("Is empty: " + map.isEmpty());
+        
+        System.out.println("\nBenchmark (1M keys):");
+        benchmark(1 << 20);
+    }
+}
@@ -0,0 +1,494 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define GROUP_SIZE 16
+#define INITIAL_CAPACITY 16
+#define MAX_LOAD_NUMERATOR 7
+#define MAX_LOAD_DENOMINATOR 8
+
+// Control byte values: full slots store the low 7 bits of the hash (0..127)
+#define CTRL_EMPTY ((int8_t)-128)
+#define CTRL_DELETED ((int8_t)-2)
+
+typedef struct Slot {
+    char *key;
+    int value;
+} Slot;
+
+typedef struct SwissHashMap {
+    int8_t *ctrl;       // One control byte per slot, scanned a group at a time
+    Slot *slots;        // Flat slot array, no chain nodes
+    int capacity;       // Always a multiple of GROUP_SIZE and a power of two
+    int size;
+    int deleted;        // Tombstones still counted against the load factor
+} SwissHashMap;
+
+// 64-bit FNV-1a with a final avalanche so both h1 and h2 get well-mixed bits
+uint64_t hash(const char *key) {
+    uint64_t hashValue = 1469598103934665603ULL;
+    int c;
+
+    while ((c = (unsigned char)*key++)) {
+        hashValue ^= (uint64_t)c;
+        hashValue *= 1099511628211ULL;
+    }
+
+    hashValue ^= hashValue >> 33;
+    hashValue *= 0xff51afd7ed558ccdULL;
+    hashValue ^= hashValue >> 33;
+    return hashValue;
+}
+
+// Group position comes from the high bits, fingerprint from the low 7 bits
+static inline uint64_t h1(uint64_t hashValue) {
+    return hashValue >> 7;
+}
+
+static inline int8_t h2(uint64_t hashValue) {
+    return (int8_t)(hashValue & 0x7F);
+}
+
+// Bitmask of slots in a group whose control byte equals value
+static inline unsigned int matchByte(const int8_t *group, int8_t value) {
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    __m128i match = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value));
+    return (unsigned int)_mm_movemask_epi8(match);
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < GROUP_SIZE; i++) {
+        if (group[i] == value)
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+// Bitmask of slots in a group that are empty or deleted (high bit set)
+static inline unsigned int matchEmptyOrDeleted(const int8_t *group) {
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (unsigned int)_mm_movemask_epi8(ctrl);
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < GROUP_SIZE; i++) {
+        if (group[i] < 0)
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+// Initialize hash map with room for capacity slots (rounded up to whole groups)
+SwissHashMap* createHashMapWithCapacity(int capacity) {
+    int rounded = INITIAL_CAPACITY;
+    while (rounded < capacity)
+        rounded *= 2;
+
+    SwissHashMap *map = (SwissHashMap*)malloc(sizeof(SwissHashMap));
+    map->capacity = rounded;
+    map->size = 0;
+    map->deleted = 0;
+    map->ctrl = (int8_t*)malloc(rounded);
+    memset(map->ctrl, CTRL_EMPTY, rounded);
+    map->slots = (Slot*)malloc(rounded * sizeof(Slot));
+    return map;
+}
+
+// Initialize hash map
+SwissHashMap* createHashMap() {
+    return createHashMapWithCapacity(INITIAL_CAPACITY);
+}
+
+// Get load factor
+double getLoadFactor(SwissHashMap *map) {
+    return (double)map->size / map->capacity;
+}
+
+// Find the slot holding key, or -1. Probes whole groups quadratically.
+int findSlot(SwissHashMap *map, const char *key, uint64_t hashValue) {
+    int groupMask = map->capacity / GROUP_SIZE - 1;
+    int group = (int)(h1(hashValue) & groupMask);
+    int8_t fingerprint = h2(hashValue);
+
+    for (int step = 1; ; step++) {
+        const int8_t *ctrl = map->ctrl + group * GROUP_SIZE;
+        unsigned int candidates = matchByte(ctrl, fingerprint);
+
+        while (candidates != 0) {
+            int offset = __builtin_ctz(candidates);
+            int index = group * GROUP_SIZE + offset;
+            if (strcmp(map->slots[index].key, key) == 0)
+                return index;
+            candidates &= candidates - 1;
+        }
+
+        // An empty slot ends the probe sequence: the key was never placed further
+        if (matchByte(ctrl, CTRL_EMPTY) != 0)
+            return -1;
+
+        group = (group + step) & groupMask;
+    }
+}
+
+// First empty or deleted slot on the probe sequence for hashValue
+int findInsertSlot(SwissHashMap *map, uint64_t hashValue) {
+    int groupMask = map->capacity / GROUP_SIZE - 1;
+    int group = (int)(h1(hashValue) & groupMask);
+
+    for (int step = 1; ; step++) {
+        unsigned int available = matchEmptyOrDeleted(map->ctrl + group * GROUP_SIZE);
+        if (available != 0)
+            return group * GROUP_SIZE + __builtin_ctz(available);
+        group = (group + step) & groupMask;
+    }
+}
+
+// Rebuild into a table of newCapacity slots, dropping tombstones
+void resize(SwissHashMap *map, int newCapacity) {
+    int oldCapacity = map->capacity;
+    int8_t *oldCtrl = map->ctrl;
+    Slot *oldSlots = map->slots;
+
+    map->capacity = newCapacity;
+    map->ctrl = (int8_t*)malloc(newCapacity);
+    memset(map->ctrl, CTRL_EMPTY, newCapacity);
+    map->slots = (Slot*)malloc(newCapacity * sizeof(Slot));
+    map->deleted = 0;
+
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldCtrl[i] < 0)
+            continue;
+
+        uint64_t hashValue = hash(oldSlots[i].key);
+        int index = findInsertSlot(map, hashValue);
+        map->ctrl[index] = h2(hashValue);
+        map->slots[index] = oldSlots[i];
+    }
+
+    free(oldCtrl);
+    free(oldSlots);
+}
+
+// Put a key-value pair into the map
+void put(SwissHashMap *map, const char *key, int value) {
+    uint64_t hashValue = hash(key);
+    int index = findSlot(map, key, hashValue);
+
+    // Update if key already exists
+    if (index >= 0) {
+        map->slots[index].value = value;
+        return;
+    }
+
+    // Grow (or just purge tombstones) once the next insert would pass 7/8 full
+    if ((long)(map->size + map->deleted + 1) * MAX_LOAD_DENOMINATOR >
+        (long)map->capacity * MAX_LOAD_NUMERATOR) {
+        if ((long)(map->size + 1) * 2 * MAX_LOAD_DENOMINATOR > (long)map->capacity * MAX_LOAD_NUMERATOR)
+            resize(map, map->capacity * 2);
+        else
+            resize(map, map->capacity);
+    }
+
+    index = findInsertSlot(map, hashValue);
+    if (map->ctrl[index] == CTRL_DELETED)
+        map->deleted--;
+
+    map->ctrl[index] = h2(hashValue);
+    map->slots[index].key = (char*)malloc(strlen(key) + 1);
+    strcpy(map->slots[index].key, key);
+    map->slots[index].value = value;
+    map->size++;
+}
+
+// Get value for a key
+int get(SwissHashMap *map, const char *key, bool *found) {
+    int index = findSlot(map, key, hash(key));
+
+    if (index < 0) {
+        *found = false;
+        return -1;
+    }
+
+    *found = true;
+    return map->slots[index].value;
+}
+
+// Check if key exists
+bool containsKey(SwissHashMap *map, const char *key) {
+    return findSlot(map, key, hash(key)) >= 0;
+}
+
+// Remove a key-value pair
+bool removeKey(SwissHashMap *map, const char *key) {
+    int index = findSlot(map, key, hash(key));
+    if (index < 0)
+        return false;
+
+    free(map->slots[index].key);
+
+    // If the group still has an empty slot no probe ever ran past it,
+    // so the slot can go straight back to empty instead of a tombstone
+    const int8_t *group = map->ctrl + (index / GROUP_SIZE) * GROUP_SIZE;
+    if (matchByte(group, CTRL_EMPTY) != 0) {
+        map->ctrl[index] = CTRL_EMPTY;
+    } else {
+        map->ctrl[index] = CTRL_DELETED;
+        map->deleted++;
+    }
+
+    map->size--;
+    return true;
+}
+
+// Clear all entries
+void clear(SwissHashMap *map) {
+    for (int i = 0; i < map->capacity; i++) {
+        if (map->ctrl[i] >= 0)
+            free(map->slots[i].key);
+    }
+    memset(map->ctrl, CTRL_EMPTY, map->capacity);
+    map->size = 0;
+    map->deleted = 0;
+}
+
+// Check if map is empty
+bool isEmpty(SwissHashMap *map) {
+    return map->size == 0;
+}
+
+// Get size of map
+int getSize(SwissHashMap *map) {
+    return map->size;
+}
+
+// Print the hash map
+void printHashMap(SwissHashMap *map) {
+    printf("SwissHashMap (size: %d, capacity: %d, load factor: %.2f):\n",
+           map->size, map->capacity, getLoadFactor(map));
+
+    for (int g = 0; g < map->capacity / GROUP_SIZE; g++) {
+        printf("Group %d: ", g);
+        for (int i = g * GROUP_SIZE; i < (g + 1) * GROUP_SIZE; i++) {
+            if (map->ctrl[i] >= 0)
+                printf("[%s: %d] ", map->slots[i].key, map->slots[i].value);
+        }
+        printf("\n");
+    }
+}
+
+// Free the hash map
+void freeHashMap(SwissHashMap *map) {
+    clear(map);
+    free(map->ctrl);
+    free(map->slots);
+    free(map);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark against the chained layout used by HashMap.c
+// ---------------------------------------------------------------------------
+
+typedef struct ChainedEntry {
+    char *key;
+    int value;
+    struct ChainedEntry *next;
+} ChainedEntry;
+
+typedef struct ChainedMap {
+    ChainedEntry **buckets;
+    int capacity;
+} ChainedMap;
+
+unsigned int chainedHash(const char *key, int capacity) {
+    unsigned long hashValue = 5381;
+    int c;
+
+    while ((c = *key++))
+        hashValue = ((hashValue << 5) + hashValue) + c;
+
+    return hashValue % capacity;
+}
+
+void chainedPut(ChainedMap *map, const char *key, int value) {
+    unsigned int index = chainedHash(key, map->capacity);
+    ChainedEntry *entry = (ChainedEntry*)malloc(sizeof(ChainedEntry));
+    entry->key = (char*)malloc(strlen(key) + 1);
+    strcpy(entry->key, key);
+    entry->value = value;
+    entry->next = map->buckets[index];
+    map->buckets[index] = entry;
+}
+
+bool chainedContains(ChainedMap *map, const char *key) {
+    ChainedEntry *entry = map->buckets[chainedHash(key, map->capacity)];
+
+    while (entry != NULL) {
+        if (strcmp(entry->key, key) == 0)
+            return true;
+        entry = entry->next;
+    }
+
+    return false;
+}
+
+void freeChainedMap(ChainedMap *map) {
+    for (int i = 0; i < map->capacity; i++) {
+        ChainedEntry *entry = map->buckets[i];
+        while (entry != NULL) {
+            ChainedEntry *next = entry->next;
+            free(entry->key);
+            free(entry);
+            entry = next;
+        }
+    }
+    free(map->buckets);
+}
+
+double elapsedNs(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+// Fill both maps to the same load factor over the same number of slots/buckets,
+// then time successful and unsuccessful lookups
+void benchmark(int capacity, double loadFactor) {
+    int n = (int)(capacity * loadFactor);
+    char **keys = (char**)malloc(n * sizeof(char*));
+    char **misses = (char**)malloc(n * sizeof(char*));
+
+    for (int i = 0; i < n; i++) {
+        keys[i] = (char*)malloc(24);
+        misses[i] = (char*)malloc(24);
+        sprintf(keys[i], "key%d", i);
+        sprintf(misses[i], "miss%d", i);
+    }
+
+    // Shuffle so neither layout benefits from djb2 mapping sequential keys to
+    // sequential buckets; real lookups arrive in no particular order
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        char *temp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = temp;
+    }
+
+    SwissHashMap *swiss = createHashMapWithCapacity(capacity);
+    ChainedMap chained;
+    chained.capacity = capacity;
+    chained.buckets = (ChainedEntry**)calloc(capacity, sizeof(ChainedEntry*));
+
+    for (int i = 0; i < n; i++) {
+        put(swiss, keys[i], i);
+        chainedPut(&chained, keys[i], i);
+    }
+
+    struct timespec start, end;
+    long hits = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) hits += containsKey(swiss, keys[i]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double swissHit = elapsedNs(start, end) / n;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) hits += containsKey(swiss, misses[i]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double swissMiss = elapsedNs(start, end) / n;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) hits += chainedContains(&chained, keys[i]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double chainedHit = elapsedNs(start, end) / n;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < n; i++) hits += chainedContains(&chained, misses[i]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double chainedMiss = elapsedNs(start, end) / n;
+
+    printf("%5.3f  %9.1f  %9.1f  %9.1f  %9.1f  (hits: %ld)\n",
+           loadFactor, swissHit, chainedHit, swissMiss, chainedMiss, hits);
+
+    freeHashMap(swiss);
+    freeChainedMap(&chained);
+    for (int i = 0; i < n; i++) {
+        free(keys[i]);
+        free(misses[i]);
+    }
+    free(keys);
+    free(misses);
+}
+
+// Example usage
+int main() {
+    SwissHashMap *map = createHashMap();
+
+    // Insert key-value pairs
+    printf("Inserting elements...\n");
+    put(map, "apple", 100);
+    put(map, "banana", 200);
+    put(map, "orange", 300);
+    put(map, "grape", 400);
+    put(map, "mango", 500);
+
+    printHashMap(map);
+
+    // Get values
+    printf("\nGetting values:\n");
+    bool found;
+    int value = get(map, "banana", &found);
+    printf("banana: %s (value: %d)\n", found ? "found" : "not found", value);
+
+    value = get(map, "cherry", &found);
+    printf("cherry: %s\n", found ? "found" : "not found");
+
+    // Check if key exists
+    printf("\nContains key 'apple': %s\n", containsKey(map, "apple") ? "yes" : "no");
+    printf("Contains key 'cherry': %s\n", containsKey(map, "cherry") ? "yes" : "no");
+
+    // Update value
+    printf("\nUpdating 'apple' to 150...\n");
+    put(map, "apple", 150);
+    value = get(map, "apple", &found);
+    printf("apple: %d\n", value);
+
+    // Remove a key
+    printf("\nRemoving 'banana'...\n");
+    removeKey(map, "banana");
+    printf("Size after removal: %d\n", getSize(map));
+    printf("Contains key 'banana': %s\n", containsKey(map, "banana") ? "yes" : "no");
+
+    // Test resizing by adding many elements
+    printf("\nAdding more elements to trigger resize...\n");
+    for (int i = 0; i < 20; i++) {
+        char key[20];
+        sprintf(key, "key%d", i);
+        put(map, key, i * 10);
+    }
+
+    printHashMap(map);
+
+    // Clear the map
+    printf("\nClearing map...\n");
+    clear(map);
+    printf("Size after clear: %d\n", getSize(map));
+    printf("Is empty: %s\n", isEmpty(map) ? "yes" : "no");
+
+    freeHashMap(map);
+
+    // Lookup cost per operation (ns) over 2^20 slots/buckets
+    printf("\nBenchmark (ns per lookup, 2^20 slots):\n");
+    printf(" load   swiss-hit  chain-hit swiss-miss chain-miss\n");
+    double loadFactors[] = {0.5, 0.625, 0.75, 0.875};
+    for (int i = 0; i < 4; i++)
+        benchmark(1 << 20, loadFactors[i]);
+
+    return 0;
+}
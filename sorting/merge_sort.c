@@ -1,58 +1,102 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
 #include <time.h>
 
-void merge_sort(int arr[], int size);
-void merge_sorted_arrays(int arr[], int start, int mid, int end);
-void merge_sort_recursion(int arr[], int start, int end);
+// Runs this short are insertion sorted in place before the first merge pass
+#define INITIAL_RUN 32
+
+bool merge_sort(int arr[], size_t size);
+void merge_sorted_arrays(const int src[], int dst[], size_t start, size_t mid, size_t end);
+void insertion_sort(int arr[], size_t size);
+
+// Bottom-up merge sort. Runs of INITIAL_RUN elements are insertion sorted
+// first, then each pass merges neighbouring runs of width w into runs of 2w.
+// Passes alternate between arr and a single n-sized scratch buffer allocated
+// once, so a pass writes straight into the other array and nothing is copied
+// back until the end (and then only if the last pass landed in the buffer).
+// Indices are size_t so arrays beyond 2^31 elements work. Returns false,
+// leaving arr untouched, if the scratch buffer cannot be allocated.
+bool merge_sort(int arr[], size_t size) {
+    if (size < 2) {
+        return true;
+    }
 
-//
+    int *buffer = malloc(size * sizeof(int));
+    if (buffer == NULL) {
+        return false;
+    }
 
-void merge_sort(int arr[], int size) {
-    merge_sort_recursion(arr, 0, size - 1);
-}
+    for (size_t start = 0; start < size; start += INITIAL_RUN) {
+        size_t run = size - start < INITIAL_RUN ? size - start : INITIAL_RUN;
+        insertion_sort(arr + start, run);
+    }
 
-void merge_sort_recursion(int arr[], int start, int end) {
-    if (start < end) {
-        int mid = start + (end - start) / 2;
+    int *src = arr;
+    int *dst = buffer;
+
+    for (size_t width = INITIAL_RUN; width < size; width *= 2) {
+        for (size_t start = 0; start < size; start += 2 * width) {
+            size_t mid = size - start > width ? start + width : size;
+            size_t end = size - mid > width ? mid + width : size;
+
+            // A lone trailing run, or two runs already in order, only need
+            // to move to the other array
+            if (mid == end || src[mid - 1] <= src[mid]) {
+                memcpy(dst + start, src + start, (end - start) * sizeof(int));
+            } else {
+                merge_sorted_arrays(src, dst, start, mid, end);
+            }
+        }
 
-        merge_sort_recursion(arr, start, mid);
-        merge_sort_recursion(arr, mid + 1, end);
+        int *temp = src;
+        src = dst;
+        dst = temp;
+    }
 
-        merge_sorted_arrays(arr, start, mid, end);
+    if (src != arr) {
+        memcpy(arr, src, size * sizeof(int));
     }
-}
 
-void merge_sorted_arrays(int arr[], int start, int mid, int end) {
-    int left_size = mid - start + 1;
-    int right_size = end - mid;
+    free(buffer);
+    return true;
+}
 
-    int temp_left[left_size];
-    int temp_right[right_size];
+// Merge src[start, mid) and src[mid, end) into dst[start, end). Taking from
+// the left run on ties keeps the sort stable.
+void merge_sorted_arrays(const int src[], int dst[], size_t start, size_t mid, size_t end) {
+    size_t i = start, m = mid, k = start;
 
-    for (int i = 0; i < left_size; i++) {
-        temp_left[i] = arr[start + i];
+    while (i < mid && m < end) {
+        if (src[i] <= src[m]) {
+            dst[k++] = src[i++];
+        } else {
+            dst[k++] = src[m++];
+        }
     }
 
-    for (int i = 0; i < right_size; i++) {
-        temp_right[i] = arr[mid + 1 + i];
-    }
+    memcpy(dst + k, src + i, (mid - i) * sizeof(int));
+    k += mid - i;
+    memcpy(dst + k, src + m, (end - m) * sizeof(int));
+}
 
-    int i = 0, m = 0;
+void insertion_sort(int arr[], size_t size) {
+    for (size_t i = 1; i < size; i++) {
+        int key = arr[i];
+        size_t m = i;
 
-    for (int k = start; k <= end; k++) {
-        if ((i < left_size) && (m >= right_size || temp_left[i] <= temp_right[m])) {
-            arr[k] = temp_left[i];
-            i++;
-        } else {
-            arr[k] = temp_right[m];
-            m++;
+        while (m > 0 && arr[m - 1] > key) {
+            arr[m] = arr[m - 1];
+            m--;
         }
+
+        arr[m] = key;
     }
 }
 
-void print_array(int arr[], int size) {
-    for (int i = 0; i < size; i++) {
+void print_array(int arr[], size_t size) {
+    for (size_t i = 0; i < size; i++) {
         printf("%d ", arr[i]);
     }
 
@@ -63,7 +107,7 @@ int main() {
     srand(time(NULL));
 
     int n = 50;
-    int array[n];
+    int *array = malloc(n * sizeof(int));
 
     for (int i = 0; i < n; i++) {
         int random = rand() % 100 + 1;
@@ -77,6 +121,27 @@ int main() {
 
     printf("\nArray After Merge Sort:\n");
     print_array(array, n);
+    free(array);
+
+    // Large enough that the old per-merge stack arrays would overflow the stack
+    size_t large = 10000000;
+    int *big = malloc(large * sizeof(int));
+    for (size_t i = 0; i < large; i++) {
+        big[i] = rand();
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool sorted = merge_sort(big, large);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    for (size_t i = 1; sorted && i < large; i++) {
+        sorted = big[i - 1] <= big[i];
+    }
+
+    printf("\n%zu random elements: %s in %.2f ms\n", large, sorted ? "sorted" : "NOT sorted",
+           (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    free(big);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,389 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+// Runs this short are insertion sorted in place before the first merge pass
+#define INITIAL_RUN 32
+// Smallest block worth a thread of its own; smaller inputs use fewer threads
+#define MIN_BLOCK 4096
+
+// Sorted by key; payload is carried along, so a stable sort keeps records
+// with equal keys in their original order
+typedef struct record {
+    int key;
+    int payload;
+} record;
+
+typedef struct sort_job {
+    record *arr;
+    record *buffer;
+    size_t size;
+    int num_threads;
+    pthread_barrier_t barrier;
+    // Workers wait here until every thread has been created: start_state is
+    // 0 while waiting, 1 to start sorting, -1 to exit without touching arr
+    pthread_mutex_t start_lock;
+    pthread_cond_t start_cond;
+    int start_state;
+} sort_job;
+
+typedef struct sort_worker {
+    pthread_t thread;
+    sort_job *job;
+    int id;
+} sort_worker;
+
+bool parallel_merge_sort(record arr[], size_t size, int num_threads);
+void *run_sort_worker(void *arg);
+void merge_pass_slice(const record src[], record dst[], size_t size, size_t width,
+                      size_t out_start, size_t out_end);
+size_t co_rank(size_t k, const record left[], size_t left_size,
+               const record right[], size_t right_size);
+void merge_runs(const record left[], size_t left_size, const record right[], size_t right_size,
+                record dst[]);
+void merge_sort_block(record arr[], record buffer[], size_t size);
+void insertion_sort(record arr[], size_t size);
+
+// Stable parallel merge sort. The array is cut into one block per thread and
+// every thread sorts its block with the serial bottom-up merge sort. Then
+// each pass merges neighbouring runs into runs twice as long, and every pass
+// is split evenly across all threads by output position, not by run. A
+// thread finds where its slice of a merge starts in each input run by binary
+// search (co-ranking), so the last merges, where there are fewer runs than
+// threads, keep every core busy. Passes ping-pong between arr and a single
+// scratch buffer, separated by a barrier. Every thread gets at least
+// MIN_BLOCK records, and if the threads cannot be started the array is
+// sorted on the calling thread instead. Returns false, leaving arr
+// untouched, if the scratch buffer cannot be allocated.
+bool parallel_merge_sort(record arr[], size_t size, int num_threads) {
+    if (size < 2) {
+        return true;
+    }
+
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    if ((size_t)num_threads > size / MIN_BLOCK) {
+        num_threads = size / MIN_BLOCK > 0 ? size / MIN_BLOCK : 1;
+    }
+
+    record *buffer = malloc(size * sizeof(record));
+    if (buffer == NULL) {
+        return false;
+    }
+
+    // A single thread, or no room for the worker table: sort on this thread
+    sort_worker *workers = num_threads > 1 ? malloc(num_threads * sizeof(sort_worker)) : NULL;
+    if (workers == NULL) {
+        merge_sort_block(arr, buffer, size);
+        free(buffer);
+        return true;
+    }
+
+    sort_job job;
+    job.arr = arr;
+    job.buffer = buffer;
+    job.size = size;
+    job.num_threads = num_threads;
+    pthread_mutex_init(&job.start_lock, NULL);
+    pthread_cond_init(&job.start_cond, NULL);
+    job.start_state = 0;
+
+    int started = 0;
+    while (started < num_threads) {
+        workers[started].job = &job;
+        workers[started].id = started;
+        if (pthread_create(&workers[started].thread, NULL, run_sort_worker, &workers[started]) != 0) {
+            break;
+        }
+        started++;
+    }
+
+    // The barrier needs every party, so it only exists once all have started
+    bool all_started = started == num_threads &&
+                       pthread_barrier_init(&job.barrier, NULL, num_threads) == 0;
+
+    pthread_mutex_lock(&job.start_lock);
+    job.start_state = all_started ? 1 : -1;
+    pthread_cond_broadcast(&job.start_cond);
+    pthread_mutex_unlock(&job.start_lock);
+
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+
+    if (all_started) {
+        pthread_barrier_destroy(&job.barrier);
+    } else {
+        merge_sort_block(arr, buffer, size);
+    }
+
+    pthread_cond_destroy(&job.start_cond);
+    pthread_mutex_destroy(&job.start_lock);
+    free(workers);
+    free(buffer);
+    return true;
+}
+
+void *run_sort_worker(void *arg) {
+    sort_worker *worker = (sort_worker *)arg;
+    sort_job *job = worker->job;
+
+    pthread_mutex_lock(&job->start_lock);
+    while (job->start_state == 0) {
+        pthread_cond_wait(&job->start_cond, &job->start_lock);
+    }
+    bool start = job->start_state > 0;
+    pthread_mutex_unlock(&job->start_lock);
+
+    if (!start) {
+        return NULL;
+    }
+
+    size_t size = job->size;
+    size_t threads = job->num_threads;
+
+    // Sort this thread's block; merge_sort_block() leaves it in arr
+    size_t block = (size + threads - 1) / threads;
+    size_t block_start = worker->id * block < size ? worker->id * block : size;
+    size_t block_end = block_start + block < size ? block_start + block : size;
+    merge_sort_block(job->arr + block_start, job->buffer + block_start, block_end - block_start);
+    pthread_barrier_wait(&job->barrier);
+
+    // This thread's share of the output of every merge pass
+    size_t out_start = size / threads * worker->id + (size % threads) * worker->id / threads;
+    size_t out_end = size / threads * (worker->id + 1) + (size % threads) * (worker->id + 1) / threads;
+
+    record *src = job->arr;
+    record *dst = job->buffer;
+
+    for (size_t width = block; width < size; width *= 2) {
+        merge_pass_slice(src, dst, size, width, out_start, out_end);
+        pthread_barrier_wait(&job->barrier);
+
+        record *temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    if (src != job->arr) {
+        memcpy(job->arr + out_start, src + out_start, (out_end - out_start) * sizeof(record));
+    }
+
+    return NULL;
+}
+
+// Write dst[out_start, out_end) of one merge pass: the output of merging
+// every pair of neighbouring runs of width in src, restricted to the slice
+void merge_pass_slice(const record src[], record dst[], size_t size, size_t width,
+                      size_t out_start, size_t out_end) {
+    for (size_t start = out_start / (2 * width) * (2 * width); start < out_end; start += 2 * width) {
+        size_t mid = size - start > width ? start + width : size;
+        size_t end = size - mid > width ? mid + width : size;
+
+        size_t slice_start = out_start > start ? out_start : start;
+        size_t slice_end = out_end < end ? out_end : end;
+
+        // A lone trailing run, or two runs already in order, only need to
+        // move to the other array
+        if (mid == end || src[mid - 1].key <= src[mid].key) {
+            memcpy(dst + slice_start, src + slice_start, (slice_end - slice_start) * sizeof(record));
+            continue;
+        }
+
+        size_t left_size = mid - start;
+        size_t right_size = end - mid;
+        size_t i_start = co_rank(slice_start - start, src + start, left_size, src + mid, right_size);
+        size_t i_end = co_rank(slice_end - start, src + start, left_size, src + mid, right_size);
+        size_t j_start = slice_start - start - i_start;
+        size_t j_end = slice_end - start - i_end;
+
+        merge_runs(src + start + i_start, i_end - i_start, src + mid + j_start, j_end - j_start,
+                   dst + slice_start);
+    }
+}
+
+// Co-rank: the number i of elements taken from left when the stable merge
+// of left and right has written its first k elements (the other k - i come
+// from right). Ties go to left, so left[i - 1] <= right[k - i] and
+// right[k - i - 1] < left[i] wherever those elements exist.
+size_t co_rank(size_t k, const record left[], size_t left_size,
+               const record right[], size_t right_size) {
+    size_t low = k > right_size ? k - right_size : 0;
+    size_t high = k < left_size ? k : left_size;
+
+    while (true) {
+        size_t i = low + (high - low) / 2;
+        size_t j = k - i;
+
+        if (i > 0 && j < right_size && left[i - 1].key > right[j].key) {
+            high = i - 1;       // took a left element that belongs after right[j]
+        } else if (j > 0 && i < left_size && right[j - 1].key >= left[i].key) {
+            low = i + 1;        // took right[j - 1] ahead of a left element it ties or exceeds
+        } else {
+            return i;
+        }
+    }
+}
+
+// Stable merge of two sorted runs into dst; ties take from left
+void merge_runs(const record left[], size_t left_size, const record right[], size_t right_size,
+                record dst[]) {
+    size_t i = 0, m = 0, k = 0;
+
+    while (i < left_size && m < right_size) {
+        if (left[i].key <= right[m].key) {
+            dst[k++] = left[i++];
+        } else {
+            dst[k++] = right[m++];
+        }
+    }
+
+    memcpy(dst + k, left + i, (left_size - i) * sizeof(record));
+    k += left_size - i;
+    memcpy(dst + k, right + m, (right_size - m) * sizeof(record));
+}
+
+// Serial bottom-up merge sort of arr, as in merge_sort.c, using buffer (the
+// same size) as scratch; the result always ends up in arr
+void merge_sort_block(record arr[], record buffer[], size_t size) {
+    for (size_t start = 0; start < size; start += INITIAL_RUN) {
+        size_t run = size - start < INITIAL_RUN ? size - start : INITIAL_RUN;
+        insertion_sort(arr + start, run);
+    }
+
+    record *src = arr;
+    record *dst = buffer;
+
+    for (size_t width = INITIAL_RUN; width < size; width *= 2) {
+        merge_pass_slice(src, dst, size, width, 0, size);
+
+        record *temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    if (src != arr) {
+        memcpy(arr, src, size * sizeof(record));
+    }
+}
+
+void insertion_sort(record arr[], size_t size) {
+    for (size_t i = 1; i < size; i++) {
+        record current = arr[i];
+        size_t m = i;
+
+        while (m > 0 && arr[m - 1].key > current.key) {
+            arr[m] = arr[m - 1];
+            m--;
+        }
+
+        arr[m] = current;
+    }
+}
+
+void print_records(record arr[], size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        printf("%d:%d ", arr[i].key, arr[i].payload);
+    }
+
+    printf("\n");
+}
+
+// Keys ascending and, among equal keys, payloads (the original positions)
+// ascending: exactly the output of a stable sort
+bool is_stably_sorted(record arr[], size_t size) {
+    for (size_t i = 1; i < size; i++) {
+        if (arr[i - 1].key > arr[i].key) return false;
+        if (arr[i - 1].key == arr[i].key && arr[i - 1].payload > arr[i].payload) return false;
+    }
+
+    return true;
+}
+
+double elapsed_ms(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+// Speedup over one thread for 1, 2, 4, ... threads up to max_threads. Keys
+// repeat often, so every result is also checked for stability against the
+// single-threaded output.
+void benchmark(size_t size, int max_threads) {
+    record *input = malloc(size * sizeof(record));
+    record *expected = malloc(size * sizeof(record));
+    record *work = malloc(size * sizeof(record));
+
+    srand(1);
+    for (size_t i = 0; i < size; i++) {
+        input[i].key = rand() % 100000;
+        input[i].payload = i;
+    }
+
+    struct timespec start, end;
+    memcpy(expected, input, size * sizeof(record));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    parallel_merge_sort(expected, size, 1);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double serial = elapsed_ms(start, end);
+
+    printf("\n%zu records, 1 thread: %.2f ms (%s)\n", size, serial,
+           is_stably_sorted(expected, size) ? "stable" : "NOT stable");
+    printf("%8s %10s %10s\n", "threads", "ms", "speedup");
+
+    for (int threads = 2; ; threads *= 2) {
+        if (threads > max_threads) threads = max_threads;
+
+        memcpy(work, input, size * sizeof(record));
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        parallel_merge_sort(work, size, threads);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double ms = elapsed_ms(start, end);
+
+        if (memcmp(work, expected, size * sizeof(record)) != 0) {
+            printf("%8d   result differs from the single-threaded sort\n", threads);
+        } else {
+            printf("%8d %10.2f %9.2fx\n", threads, ms, serial / ms);
+        }
+
+        if (threads == max_threads) break;
+    }
+
+    free(input);
+    free(expected);
+    free(work);
+}
+
+int main() {
+    srand(time(NULL));
+
+    int n = 20;
+    record *records = malloc(n * sizeof(record));
+
+    // Few distinct keys, so stability is visible: payloads stay in order
+    for (int i = 0; i < n; i++) {
+        records[i].key = rand() % 5;
+        records[i].payload = i;
+    }
+
+    printf("Records Before Sort (key:payload):\n");
+    print_records(records, n);
+
+    parallel_merge_sort(records, n, 4);
+
+    printf("\nRecords After Sort (key:payload):\n");
+    print_records(records, n);
+    free(records);
+
+    // At least 8 threads so the curve has a few points even on small machines
+    int max_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (max_threads < 8) max_threads = 8;
+
+    benchmark(20000000, max_threads);
+
+    return 0;
+}
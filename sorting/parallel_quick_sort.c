@@ -0,0 +1,593 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Ranges this small are finished by insertion sort
+#define INSERTION_SORT_THRESHOLD 16
+// Ranges at least this large pick the pivot as a median of three medians
+#define NINTHER_THRESHOLD 128
+// Ranges at or below this size are sorted serially instead of being split further
+#define DEFAULT_GRAIN_SIZE 16384
+#define INITIAL_DEQUE_CAPACITY 64
+#define CACHE_LINE_SIZE 64
+
+// A subrange [start, end] still to be sorted, with its remaining introsort depth
+typedef struct Task {
+    int start;
+    int end;
+    int depth_limit;
+} Task;
+
+// Per-worker deque: the owner pushes and pops at the bottom (newest, smallest
+// ranges, still warm in its cache), thieves take from the top (oldest, largest
+// ranges, so one steal buys a lot of work). Live tasks are tasks[top, bottom).
+// Aligned so neighbouring workers' locks never share a cache line.
+typedef struct WorkDeque {
+    pthread_mutex_t lock;
+    Task *tasks;
+    int capacity;
+    int top;
+    int bottom;
+} __attribute__((aligned(CACHE_LINE_SIZE))) WorkDeque;
+
+typedef struct SortPool {
+    int *arr;
+    int grain_size;
+    int num_threads;
+    WorkDeque *deques;
+    atomic_int pending;     // tasks queued or running; the sort is done at 0
+    // Workers that find nothing to do sleep on idle_cond instead of spinning;
+    // a push or the end of the sort wakes them
+    pthread_mutex_t idle_lock;
+    pthread_cond_t idle_cond;
+    int idle;
+} SortPool;
+
+typedef struct Worker {
+    pthread_t thread;
+    SortPool *pool;
+    int id;
+    uint64_t rng;
+} Worker;
+
+void ParallelQuickSort(int arr[], int size, int num_threads, int grain_size);
+void* RunWorker(void *arg);
+bool FindTask(Worker *worker, Task *task);
+void WaitForWork(SortPool *pool);
+bool AnyQueued(SortPool *pool);
+void RunTask(SortPool *pool, WorkDeque *own, Task task);
+bool PushBottom(WorkDeque *deque, Task task);
+bool PopBottom(WorkDeque *deque, Task *task);
+bool StealTop(WorkDeque *deque, Task *task);
+void QuickSort(int arr[], int size);
+void IntroSortRecursive(int arr[], int start, int end, int depth_limit);
+int HoarePartition(int arr[], int start, int end);
+int MedianOfThree(int arr[], int a, int b, int c);
+int ChoosePivot(int arr[], int start, int end);
+void InsertionSort(int arr[], int size);
+void HeapSort(int arr[], int size);
+void BuildMaxHeap(int arr[], int size);
+void MaxHeapify(int arr[], int heap_size, int i);
+void printArray(int arr[], int size);
+
+// Parallel introsort. The top levels of the recursion are split into tasks:
+// each partition keeps one side and pushes the other onto the worker's own
+// deque, where an idle worker can steal it. Once a range is no larger than
+// grain_size it is finished serially with the same introsort as QuickSort(),
+// so the output is identical to the serial sort's. The introsort depth limit
+// travels with every task, so the O(n log n) worst case still holds. No
+// more threads are started than there are grains in the array; if the pool
+// cannot be set up the array is sorted serially with QuickSort().
+//
+// Each partition is itself serial, and the partitions along one path from the
+// root cost about n + n/2 + n/4 + ... = 2n. With P threads the speedup is
+// therefore about P log n / (2P + log n), which never exceeds log n / 2
+// (about 14x for 2^28 ints) however many cores there are.
+void ParallelQuickSort(int arr[], int size, int num_threads, int grain_size) {
+    if (num_threads < 1) num_threads = 1;
+    if (grain_size < INSERTION_SORT_THRESHOLD) grain_size = INSERTION_SORT_THRESHOLD;
+    
+    if (size <= grain_size) {
+        QuickSort(arr, size);
+        return;
+    }
+    
+    if (num_threads > size / grain_size) num_threads = size / grain_size;
+    
+    SortPool pool;
+    pool.arr = arr;
+    pool.grain_size = grain_size;
+    pool.num_threads = num_threads;
+    pool.deques = aligned_alloc(CACHE_LINE_SIZE, num_threads * sizeof(WorkDeque));
+    Worker *workers = malloc(num_threads * sizeof(Worker));
+    
+    int ready = 0;
+    if (pool.deques != NULL && workers != NULL) {
+        for (; ready < num_threads; ready++) {
+            WorkDeque *deque = &pool.deques[ready];
+            deque->capacity = INITIAL_DEQUE_CAPACITY;
+            deque->tasks = malloc(deque->capacity * sizeof(Task));
+            if (deque->tasks == NULL) break;
+            
+            pthread_mutex_init(&deque->lock, NULL);
+            deque->top = 0;
+            deque->bottom = 0;
+        }
+    }
+    
+    if (ready < num_threads) {
+        for (int i = 0; i < ready; i++) {
+            pthread_mutex_destroy(&pool.deques[i].lock);
+            free(pool.deques[i].tasks);
+        }
+        
+        free(workers);
+        free(pool.deques);
+        QuickSort(arr, size);
+        return;
+    }
+    
+    pthread_mutex_init(&pool.idle_lock, NULL);
+    pthread_cond_init(&pool.idle_cond, NULL);
+    pool.idle = 0;
+    
+    int depth_limit = 0;
+    for (int n = size; n > 1; n >>= 1) {
+        depth_limit += 2;
+    }
+    
+    // The whole array starts as one task on worker 0's deque
+    Task root = {0, size - 1, depth_limit};
+    atomic_init(&pool.pending, 1);
+    PushBottom(&pool.deques[0], root);      // fits the initial capacity, cannot fail
+    
+    int started = 0;
+    for (; started < num_threads; started++) {
+        workers[started].pool = &pool;
+        workers[started].id = started;
+        workers[started].rng = 0x9e3779b97f4a7c15ULL * (started + 1);
+        if (pthread_create(&workers[started].thread, NULL, RunWorker, &workers[started]) != 0) {
+            break;
+        }
+    }
+    
+    // Any queued task can be stolen by any worker, so if a thread could not
+    // be started the calling thread takes its place (its deque is empty)
+    if (started < num_threads) {
+        RunWorker(&workers[started]);
+    }
+    
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    
+    pthread_cond_destroy(&pool.idle_cond);
+    pthread_mutex_destroy(&pool.idle_lock);
+    
+    for (int i = 0; i < num_threads; i++) {
+        pthread_mutex_destroy(&pool.deques[i].lock);
+        free(pool.deques[i].tasks);
+    }
+    
+    free(workers);
+    free(pool.deques);
+}
+
+// Run tasks until no task is queued or running anywhere, sleeping whenever
+// every deque is empty
+void* RunWorker(void *arg) {
+    Worker *worker = (Worker*)arg;
+    SortPool *pool = worker->pool;
+    WorkDeque *own = &pool->deques[worker->id];
+    
+    while (atomic_load_explicit(&pool->pending, memory_order_acquire) > 0) {
+        Task task;
+        if (FindTask(worker, &task)) {
+            RunTask(pool, own, task);
+        } else {
+            WaitForWork(pool);
+        }
+    }
+    
+    return NULL;
+}
+
+// Take work from the own deque first, then try to steal from the others,
+// starting at a random victim so thieves spread out instead of all hitting
+// the same deque
+bool FindTask(Worker *worker, Task *task) {
+    SortPool *pool = worker->pool;
+    if (PopBottom(&pool->deques[worker->id], task)) return true;
+    
+    // xorshift64: cheap per-thread random numbers with no shared state
+    uint64_t x = worker->rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    worker->rng = x;
+    
+    int victim = x % pool->num_threads;
+    for (int i = 0; i < pool->num_threads; i++) {
+        int v = (victim + i) % pool->num_threads;
+        if (v != worker->id && StealTop(&pool->deques[v], task)) return true;
+    }
+    
+    return false;
+}
+
+// Sleep until a task is pushed or the sort is done. Both are re-checked
+// under idle_lock, which pushers and the finishing worker take before
+// signalling, so a wakeup cannot slip in between the check and the wait.
+void WaitForWork(SortPool *pool) {
+    pthread_mutex_lock(&pool->idle_lock);
+    pool->idle++;
+    
+    while (atomic_load_explicit(&pool->pending, memory_order_acquire) > 0 && !AnyQueued(pool)) {
+        pthread_cond_wait(&pool->idle_cond, &pool->idle_lock);
+    }
+    
+    pool->idle--;
+    pthread_mutex_unlock(&pool->idle_lock);
+}
+
+bool AnyQueued(SortPool *pool) {
+    for (int i = 0; i < pool->num_threads; i++) {
+        WorkDeque *deque = &pool->deques[i];
+        pthread_mutex_lock(&deque->lock);
+        bool queued = deque->bottom > deque->top;
+        pthread_mutex_unlock(&deque->lock);
+        
+        if (queued) return true;
+    }
+    
+    return false;
+}
+
+// Split the range until it fits the grain, pushing the larger side of every
+// partition for others to steal and carrying on with the smaller one
+void RunTask(SortPool *pool, WorkDeque *own, Task task) {
+    int *arr = pool->arr;
+    
+    while (task.end - task.start + 1 > pool->grain_size && task.depth_limit > 0) {
+        task.depth_limit--;
+        int split = HoarePartition(arr, task.start, task.end);
+        
+        Task other;
+        other.depth_limit = task.depth_limit;
+        if (split - task.start < task.end - split) {
+            other.start = split + 1;
+            other.end = task.end;
+            task.end = split;
+        } else {
+            other.start = task.start;
+            other.end = split;
+            task.start = split + 1;
+        }
+        
+        // Count the new task before it becomes visible, so pending cannot
+        // reach zero while it is still waiting in a deque
+        atomic_fetch_add_explicit(&pool->pending, 1, memory_order_relaxed);
+        
+        if (PushBottom(own, other)) {
+            pthread_mutex_lock(&pool->idle_lock);
+            if (pool->idle > 0) pthread_cond_signal(&pool->idle_cond);
+            pthread_mutex_unlock(&pool->idle_lock);
+        } else {
+            // No room to queue it: sort it here, it only costs parallelism
+            IntroSortRecursive(arr, other.start, other.end, other.depth_limit);
+            atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_relaxed);
+        }
+    }
+    
+    IntroSortRecursive(arr, task.start, task.end, task.depth_limit);
+    
+    // The last task to finish wakes the sleeping workers so they can exit
+    if (atomic_fetch_sub_explicit(&pool->pending, 1, memory_order_acq_rel) == 1) {
+        pthread_mutex_lock(&pool->idle_lock);
+        pthread_cond_broadcast(&pool->idle_cond);
+        pthread_mutex_unlock(&pool->idle_lock);
+    }
+}
+
+// Returns false, leaving the deque unchanged, if it is full and cannot grow
+bool PushBottom(WorkDeque *deque, Task task) {
+    pthread_mutex_lock(&deque->lock);
+    
+    if (deque->bottom == deque->capacity) {
+        // Slide the live tasks back to the front, growing only if still full
+        int live = deque->bottom - deque->top;
+        memmove(deque->tasks, deque->tasks + deque->top, live * sizeof(Task));
+        deque->top = 0;
+        deque->bottom = live;
+        
+        if (live == deque->capacity) {
+            Task *grown = realloc(deque->tasks, 2 * deque->capacity * sizeof(Task));
+            if (grown == NULL) {
+                pthread_mutex_unlock(&deque->lock);
+                return false;
+            }
+            
+            deque->tasks = grown;
+            deque->capacity *= 2;
+        }
+    }
+    
+    deque->tasks[deque->bottom++] = task;
+    pthread_mutex_unlock(&deque->lock);
+    return true;
+}
+
+bool PopBottom(WorkDeque *deque, Task *task) {
+    pthread_mutex_lock(&deque->lock);
+    
+    bool found = deque->bottom > deque->top;
+    if (found) {
+        *task = deque->tasks[--deque->bottom];
+    }
+    
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+bool StealTop(WorkDeque *deque, Task *task) {
+    pthread_mutex_lock(&deque->lock);
+    
+    bool found = deque->bottom > deque->top;
+    if (found) {
+        *task = deque->tasks[deque->top++];
+    }
+    
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// Serial introsort, the same as QuickSort() in quick_sort.c
+void QuickSort(int arr[], int size) {
+    int depth_limit = 0;
+    for (int n = size; n > 1; n >>= 1) {
+        depth_limit += 2;
+    }
+    
+    IntroSortRecursive(arr, 0, size - 1, depth_limit);
+}
+
+void IntroSortRecursive(int arr[], int start, int end, int depth_limit) {
+    while (end - start + 1 > INSERTION_SORT_THRESHOLD) {
+        if (depth_limit == 0) {
+            HeapSort(arr + start, end - start + 1);
+            return;
+        }
+        depth_limit--;
+        
+        int split = HoarePartition(arr, start, end);
+        
+        if (split - start < end - split) {
+            IntroSortRecursive(arr, start, split, depth_limit);
+            start = split + 1;
+        } else {
+            IntroSortRecursive(arr, split + 1, end, depth_limit);
+            end = split;
+        }
+    }
+    
+    InsertionSort(arr + start, end - start + 1);
+}
+
+int HoarePartition(int arr[], int start, int end) {
+    int pivot_index = ChoosePivot(arr, start, end);
+    int pivot = arr[pivot_index];
+    arr[pivot_index] = arr[start];
+    arr[start] = pivot;
+    
+    int i = start - 1;
+    int j = end + 1;
+    
+    while (true) {
+        do {
+            i++;
+        } while (arr[i] < pivot);
+        
+        do {
+            j--;
+        } while (arr[j] > pivot);
+        
+        if (i >= j) {
+            return j;
+        }
+        
+        int temp = arr[i];
+        arr[i] = arr[j];
+        arr[j] = temp;
+    }
+}
+
+int MedianOfThree(int arr[], int a, int b, int c) {
+    if (arr[a] < arr[b]) {
+        if (arr[b] < arr[c]) return b;
+        return arr[a] < arr[c] ? c : a;
+    }
+    
+    if (arr[a] < arr[c]) return a;
+    return arr[b] < arr[c] ? c : b;
+}
+
+int ChoosePivot(int arr[], int start, int end) {
+    int size = end - start + 1;
+    int mid = start + size / 2;
+    
+    if (size < NINTHER_THRESHOLD) {
+        return MedianOfThree(arr, start, mid, end);
+    }
+    
+    int step = size / 8;
+    int first = MedianOfThree(arr, start, start + step, start + 2 * step);
+    int middle = MedianOfThree(arr, mid - step, mid, mid + step);
+    int last = MedianOfThree(arr, end - 2 * step, end - step, end);
+    return MedianOfThree(arr, first, middle, last);
+}
+
+void InsertionSort(int arr[], int size) {
+    for (int i = 1; i < size; i++) {
+        int key = arr[i];
+        int m = i - 1;
+        
+        while (m >= 0 && arr[m] > key) {
+            arr[m + 1] = arr[m];
+            m--;
+        }
+        
+        arr[m + 1] = key;
+    }
+}
+
+void HeapSort(int arr[], int size) {
+    BuildMaxHeap(arr, size);
+    
+    for (int i = size - 1; i >= 1; i--) {
+        int temp = arr[0];
+        arr[0] = arr[i];
+        arr[i] = temp;
+        
+        MaxHeapify(arr, i, 0);
+    }
+}
+
+void BuildMaxHeap(int arr[], int size) {
+    for (int i = size / 2 - 1; i >= 0; i--) {
+        MaxHeapify(arr, size, i);
+    }
+}
+
+void MaxHeapify(int arr[], int heap_size, int i) {
+    int left = 2 * i + 1;
+    int right = 2 * i + 2;
+    int largest = i;
+    
+    if (left < heap_size && arr[left] > arr[largest]) {
+        largest = left;
+    }
+    
+    if (right < heap_size && arr[right] > arr[largest]) {
+        largest = right;
+    }
+    
+    if (largest != i) {
+        int temp = arr[i];
+        arr[i] = arr[largest];
+        arr[largest] = temp;
+        
+        MaxHeapify(arr, heap_size, largest);
+    }
+}
+
+void printArray(int arr[], int size) {
+    for (int i = 0; i < size; i++) {
+        printf("%d ", arr[i]);
+    }
+    
+    printf("\n");
+}
+
+double ElapsedMs(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+// Milliseconds for one parallel sort of input, or -1 if the result differs
+// from the serial sort's output in expected
+double TimeParallelSort(const int input[], const int expected[], int work[], int size,
+                        int num_threads, int grain_size) {
+    memcpy(work, input, size * sizeof(int));
+    
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ParallelQuickSort(work, size, num_threads, grain_size);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    if (memcmp(work, expected, size * sizeof(int)) != 0) return -1;
+    return ElapsedMs(start, end);
+}
+
+// Speedup over the serial sort for 1, 2, 4, ... threads up to max_threads,
+// then the effect of the grain size at max_threads. The 1-thread row runs
+// through the pool too, so the curve includes the pool's own overhead.
+void Benchmark(int size, int max_threads) {
+    int *input = malloc(size * sizeof(int));
+    int *expected = malloc(size * sizeof(int));
+    int *work = malloc(size * sizeof(int));
+    
+    srand(1);
+    for (int i = 0; i < size; i++) {
+        input[i] = rand();
+    }
+    
+    memcpy(expected, input, size * sizeof(int));
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    QuickSort(expected, size);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double serial = ElapsedMs(start, end);
+    
+    printf("\n%d random elements, serial introsort: %.2f ms\n", size, serial);
+    printf("%8s %10s %10s\n", "threads", "ms", "speedup");
+    
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > max_threads) threads = max_threads;
+        
+        double ms = TimeParallelSort(input, expected, work, size, threads, DEFAULT_GRAIN_SIZE);
+        if (ms < 0) {
+            printf("%8d   result differs from the serial sort\n", threads);
+        } else {
+            printf("%8d %10.2f %9.2fx\n", threads, ms, serial / ms);
+        }
+        
+        if (threads == max_threads) break;
+    }
+    
+    printf("\n%d threads by grain size:\n", max_threads);
+    printf("%8s %10s %10s\n", "grain", "ms", "speedup");
+    
+    int grains[] = {1024, 16384, 262144, 4194304};
+    for (int g = 0; g < 4; g++) {
+        double ms = TimeParallelSort(input, expected, work, size, max_threads, grains[g]);
+        if (ms < 0) {
+            printf("%8d   result differs from the serial sort\n", grains[g]);
+        } else {
+            printf("%8d %10.2f %9.2fx\n", grains[g], ms, serial / ms);
+        }
+    }
+    
+    free(input);
+    free(expected);
+    free(work);
+}
+
+int main() {
+    int size = 10;
+    int arr[size];
+    
+    printf("Array Before:\n");
+    for (int i = 0; i < size; i++) {
+        arr[i] = size - i;
+    }
+    
+    printArray(arr, size);
+    
+    ParallelQuickSort(arr, size, 4, DEFAULT_GRAIN_SIZE);
+    
+    printf("Array After:\n");
+    printArray(arr, size);
+    
+    // At least 8 threads so the curve has a few points even on small machines
+    int max_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (max_threads < 8) max_threads = 8;
+    
+    Benchmark(20000000, max_threads);
+    
+    return 0;
+}
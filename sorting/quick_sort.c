@@ -1,11 +1,415 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+// Ranges this small are finished by insertion sort
+#define INSERTION_SORT_THRESHOLD 16
+// Ranges at least this large pick the pivot as a median of three medians
+#define NINTHER_THRESHOLD 128
+// Elements classified per block by the branchless partition (offsets fit a byte)
+#define PARTITION_BLOCK_SIZE 64
+// Moves a partial insertion sort may make before giving up on a nearly sorted range
+#define PARTIAL_INSERTION_SORT_LIMIT 8
 
 void QuickSort(int arr[], int size);
+void IntroSortRecursive(int arr[], int start, int end, int depth_limit);
+int HoarePartition(int arr[], int start, int end);
+int MedianOfThree(int arr[], int a, int b, int c);
+int ChoosePivot(int arr[], int start, int end);
+void PdqSort(int arr[], int size);
+void PdqSortLoop(int *begin, int *end, int bad_allowed, bool leftmost);
+int *PartitionRightBranchless(int *begin, int *end, bool *already_partitioned);
+int *PartitionLeft(int *begin, int *end);
+void SwapOffsets(int *left_base, int *right_base, unsigned char *offsets_l,
+                 unsigned char *offsets_r, int num, bool use_swaps);
+bool PartialInsertionSort(int *begin, int *end);
+void UnguardedInsertionSort(int *begin, int *end);
+void ClassicQuickSort(int arr[], int size);
 void QuickSortRecursive(int arr[], int start, int end);
 int partition(int arr[], int start, int end);
+void InsertionSort(int arr[], int size);
+void HeapSort(int arr[], int size);
+void BuildMaxHeap(int arr[], int size);
+void MaxHeapify(int arr[], int heap_size, int i);
 void printArray(int arr[], int size);
 
+// Introsort: quicksort with Hoare partitioning around a median pivot, insertion
+// sort for small ranges, and heap sort for any range that recurses deeper than
+// 2 * log2(size), so the worst case is O(n log n) whatever the input
 void QuickSort(int arr[], int size) {
+    int depth_limit = 0;
+    for (int n = size; n > 1; n >>= 1) {
+        depth_limit += 2;
+    }
+    
+    IntroSortRecursive(arr, 0, size - 1, depth_limit);
+}
+
+void IntroSortRecursive(int arr[], int start, int end, int depth_limit) {
+    while (end - start + 1 > INSERTION_SORT_THRESHOLD) {
+        if (depth_limit == 0) {
+            HeapSort(arr + start, end - start + 1);
+            return;
+        }
+        depth_limit--;
+        
+        int split = HoarePartition(arr, start, end);
+        
+        // Recurse into the smaller side and loop on the larger one, so the
+        // stack never holds more than log2(size) frames
+        if (split - start < end - split) {
+            IntroSortRecursive(arr, start, split, depth_limit);
+            start = split + 1;
+        } else {
+            IntroSortRecursive(arr, split + 1, end, depth_limit);
+            end = split;
+        }
+    }
+    
+    InsertionSort(arr + start, end - start + 1);
+}
+
+// Hoare partition: afterwards every element of [start, split] is <= every
+// element of [split + 1, end], with start <= split < end. Both scans stop on
+// elements equal to the pivot, so runs of duplicates are split down the middle
+// instead of all landing on one side.
+int HoarePartition(int arr[], int start, int end) {
+    int pivot_index = ChoosePivot(arr, start, end);
+    int pivot = arr[pivot_index];
+    arr[pivot_index] = arr[start];
+    arr[start] = pivot;
+    
+    int i = start - 1;
+    int j = end + 1;
+    
+    while (true) {
+        do {
+            i++;
+        } while (arr[i] < pivot);
+        
+        do {
+            j--;
+        } while (arr[j] > pivot);
+        
+        if (i >= j) {
+            return j;
+        }
+        
+        int temp = arr[i];
+        arr[i] = arr[j];
+        arr[j] = temp;
+    }
+}
+
+int MedianOfThree(int arr[], int a, int b, int c) {
+    if (arr[a] < arr[b]) {
+        if (arr[b] < arr[c]) return b;
+        return arr[a] < arr[c] ? c : a;
+    }
+    
+    if (arr[a] < arr[c]) return a;
+    return arr[b] < arr[c] ? c : b;
+}
+
+// Median of first, middle and last; for large ranges Tukey's ninther (median
+// of the medians of three evenly spaced triples), so sorted, reversed and
+// organ-pipe inputs still get a pivot near the true median
+int ChoosePivot(int arr[], int start, int end) {
+    int size = end - start + 1;
+    int mid = start + size / 2;
+    
+    if (size < NINTHER_THRESHOLD) {
+        return MedianOfThree(arr, start, mid, end);
+    }
+    
+    int step = size / 8;
+    int first = MedianOfThree(arr, start, start + step, start + 2 * step);
+    int middle = MedianOfThree(arr, mid - step, mid, mid + step);
+    int last = MedianOfThree(arr, end - 2 * step, end - step, end);
+    return MedianOfThree(arr, first, middle, last);
+}
+
+// Pattern-defeating quicksort (pdqsort): introsort's structure, plus
+//  - branchless block partitioning (BlockQuicksort): elements on the wrong
+//    side are found a block at a time by recording offsets with no
+//    data-dependent branch, then swapped in bulk
+//  - a range the partition found already partitioned, and that split evenly,
+//    is tried with an insertion sort capped at a few moves (sorted runs: O(n))
+//  - a pivot equal to the element just before the range (the previous pivot)
+//    puts all its duplicates on the left and never looks at them again
+//  - an unbalanced split shuffles a few elements to break adversarial patterns
+//    before heap sort is needed
+// Ranges use pointers, [begin, end).
+void PdqSort(int arr[], int size) {
+    int bad_allowed = 0;
+    for (int n = size; n > 1; n >>= 1) {
+        bad_allowed++;
+    }
+    
+    PdqSortLoop(arr, arr + size, bad_allowed, true);
+}
+
+void PdqSortLoop(int *begin, int *end, int bad_allowed, bool leftmost) {
+    while (true) {
+        int size = end - begin;
+        if (size <= INSERTION_SORT_THRESHOLD) {
+            if (leftmost) {
+                InsertionSort(begin, size);
+            } else {
+                UnguardedInsertionSort(begin, end);
+            }
+            return;
+        }
+        
+        int pivot_index = ChoosePivot(begin, 0, size - 1);
+        int temp = begin[0];
+        begin[0] = begin[pivot_index];
+        begin[pivot_index] = temp;
+        
+        // Nothing in [begin, end) is smaller than begin[-1], the pivot of an
+        // enclosing partition. If this pivot equals it, gather the equal
+        // elements on the left; they are already in their final place.
+        if (!leftmost && !(begin[-1] < begin[0])) {
+            begin = PartitionLeft(begin, end) + 1;
+            continue;
+        }
+        
+        bool already_partitioned;
+        int *pivot_pos = PartitionRightBranchless(begin, end, &already_partitioned);
+        
+        int left_size = pivot_pos - begin;
+        int right_size = end - (pivot_pos + 1);
+        
+        if (left_size < size / 8 || right_size < size / 8) {
+            if (--bad_allowed == 0) {
+                HeapSort(begin, size);
+                return;
+            }
+            
+            if (left_size >= INSERTION_SORT_THRESHOLD) {
+                temp = begin[0]; begin[0] = begin[left_size / 4]; begin[left_size / 4] = temp;
+                temp = pivot_pos[-1]; pivot_pos[-1] = pivot_pos[-left_size / 4]; pivot_pos[-left_size / 4] = temp;
+            }
+            
+            if (right_size >= INSERTION_SORT_THRESHOLD) {
+                temp = pivot_pos[1]; pivot_pos[1] = pivot_pos[1 + right_size / 4]; pivot_pos[1 + right_size / 4] = temp;
+                temp = end[-1]; end[-1] = end[-right_size / 4]; end[-right_size / 4] = temp;
+            }
+        } else if (already_partitioned && PartialInsertionSort(begin, pivot_pos) &&
+                   PartialInsertionSort(pivot_pos + 1, end)) {
+            return;
+        }
+        
+        PdqSortLoop(begin, pivot_pos, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+// Partition around *begin: afterwards [begin, pivot) < pivot <= (pivot, end).
+// Returns the pivot's final position. already_partitioned is set when the
+// initial scans met without finding anything to swap.
+int *PartitionRightBranchless(int *begin, int *end, bool *already_partitioned) {
+    int pivot = *begin;
+    int *first = begin;
+    int *last = end;
+    
+    // A median pivot guarantees an element >= pivot further right, and, once
+    // first has moved, an element < pivot to stop the second scan
+    while (*++first < pivot);
+    
+    if (first - 1 == begin) {
+        while (first < last && !(*--last < pivot));
+    } else {
+        while (!(*--last < pivot));
+    }
+    
+    *already_partitioned = first >= last;
+    if (!*already_partitioned) {
+        int temp = *first;
+        *first = *last;
+        *last = temp;
+        first++;
+        
+        unsigned char offsets_l[PARTITION_BLOCK_SIZE];
+        unsigned char offsets_r[PARTITION_BLOCK_SIZE];
+        int *offsets_l_base = first;
+        int *offsets_r_base = last;
+        int num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+        
+        while (first < last) {
+            // Split the unknown middle between whichever blocks are empty
+            int num_unknown = last - first;
+            int left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+            int right_split = num_r == 0 ? num_unknown - left_split : 0;
+            
+            // Record every offset, but only advance the count for elements on
+            // the wrong side: the comparison feeds an add, not a branch
+            if (left_split > PARTITION_BLOCK_SIZE) left_split = PARTITION_BLOCK_SIZE;
+            for (int i = 0; i < left_split; i++) {
+                offsets_l[num_l] = i;
+                num_l += !(*first < pivot);
+                first++;
+            }
+            
+            if (right_split > PARTITION_BLOCK_SIZE) right_split = PARTITION_BLOCK_SIZE;
+            for (int i = 0; i < right_split; i++) {
+                offsets_r[num_r] = i + 1;
+                num_r += *--last < pivot;
+            }
+            
+            int num = num_l < num_r ? num_l : num_r;
+            SwapOffsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r,
+                        num, num_l == num_r);
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+            
+            if (num_l == 0) {
+                start_l = 0;
+                offsets_l_base = first;
+            }
+            
+            if (num_r == 0) {
+                start_r = 0;
+                offsets_r_base = last;
+            }
+        }
+        
+        // One block may still hold misplaced elements; move them to the boundary
+        if (num_l) {
+            while (num_l--) {
+                int *element = offsets_l_base + offsets_l[start_l + num_l];
+                temp = *element;
+                *element = *--last;
+                *last = temp;
+            }
+            first = last;
+        }
+        
+        if (num_r) {
+            while (num_r--) {
+                int *element = offsets_r_base - offsets_r[start_r + num_r];
+                temp = *element;
+                *element = *first;
+                *first = temp;
+                first++;
+            }
+            last = first;
+        }
+    }
+    
+    int *pivot_pos = first - 1;
+    *begin = *pivot_pos;
+    *pivot_pos = pivot;
+    return pivot_pos;
+}
+
+// Swap num pairs of misplaced elements. With unequal counts a cyclic rotation
+// moves each element once instead of three times per swap; equal counts keep
+// plain swaps so descending input stays linear.
+void SwapOffsets(int *left_base, int *right_base, unsigned char *offsets_l,
+                 unsigned char *offsets_r, int num, bool use_swaps) {
+    if (use_swaps) {
+        for (int i = 0; i < num; i++) {
+            int *l = left_base + offsets_l[i];
+            int *r = right_base - offsets_r[i];
+            int temp = *l;
+            *l = *r;
+            *r = temp;
+        }
+    } else if (num > 0) {
+        int *l = left_base + offsets_l[0];
+        int *r = right_base - offsets_r[0];
+        int temp = *l;
+        *l = *r;
+        for (int i = 1; i < num; i++) {
+            l = left_base + offsets_l[i];
+            *r = *l;
+            r = right_base - offsets_r[i];
+            *l = *r;
+        }
+        *r = temp;
+    }
+}
+
+// Partition around *begin with elements equal to the pivot on the left:
+// [begin, pivot] <= pivot < (pivot, end). Returns the pivot's final position.
+int *PartitionLeft(int *begin, int *end) {
+    int pivot = *begin;
+    int *first = begin;
+    int *last = end;
+    
+    while (pivot < *--last);
+    
+    if (last + 1 == end) {
+        while (first < last && !(pivot < *++first));
+    } else {
+        while (!(pivot < *++first));
+    }
+    
+    while (first < last) {
+        int temp = *first;
+        *first = *last;
+        *last = temp;
+        
+        while (pivot < *--last);
+        while (!(pivot < *++first));
+    }
+    
+    int *pivot_pos = last;
+    *begin = *pivot_pos;
+    *pivot_pos = pivot;
+    return pivot_pos;
+}
+
+// Insertion sort that gives up (returning false) after a few moved elements
+bool PartialInsertionSort(int *begin, int *end) {
+    if (begin == end) return true;
+    
+    int moves = 0;
+    for (int *current = begin + 1; current != end; current++) {
+        if (moves > PARTIAL_INSERTION_SORT_LIMIT) return false;
+        
+        int *sift = current;
+        int key = *current;
+        
+        if (key < sift[-1]) {
+            do {
+                *sift = sift[-1];
+                sift--;
+            } while (sift != begin && key < sift[-1]);
+            
+            *sift = key;
+            moves += current - sift;
+        }
+    }
+    
+    return true;
+}
+
+// Insertion sort for a range that is not leftmost: begin[-1] is no larger than
+// anything in it, so the inner loop needs no bounds check
+void UnguardedInsertionSort(int *begin, int *end) {
+    for (int *current = begin + 1; current < end; current++) {
+        int key = *current;
+        int *sift = current;
+        
+        while (key < sift[-1]) {
+            *sift = sift[-1];
+            sift--;
+        }
+        
+        *sift = key;
+    }
+}
+
+// The original quicksort with a Lomuto partition around arr[end], kept for
+// comparison: quadratic (and n frames deep) on sorted, reversed or
+// duplicate-heavy input
+void ClassicQuickSort(int arr[], int size) {
     QuickSortRecursive(arr, 0, size - 1);
 }
 
@@ -38,6 +442,60 @@ int partition(int arr[], int start, int end) {
     return m;
 }
 
+void InsertionSort(int arr[], int size) {
+    for (int i = 1; i < size; i++) {
+        int key = arr[i];
+        int m = i - 1;
+        
+        while (m >= 0 && arr[m] > key) {
+            arr[m + 1] = arr[m];
+            m--;
+        }
+        
+        arr[m + 1] = key;
+    }
+}
+
+void HeapSort(int arr[], int size) {
+    BuildMaxHeap(arr, size);
+    
+    for (int i = size - 1; i >= 1; i--) {
+        int temp = arr[0];
+        arr[0] = arr[i];
+        arr[i] = temp;
+        
+        MaxHeapify(arr, i, 0);
+    }
+}
+
+void BuildMaxHeap(int arr[], int size) {
+    for (int i = size / 2 - 1; i >= 0; i--) {
+        MaxHeapify(arr, size, i);
+    }
+}
+
+void MaxHeapify(int arr[], int heap_size, int i) {
+    int left = 2 * i + 1;
+    int right = 2 * i + 2;
+    int largest = i;
+    
+    if (left < heap_size && arr[left] > arr[largest]) {
+        largest = left;
+    }
+    
+    if (right < heap_size && arr[right] > arr[largest]) {
+        largest = right;
+    }
+    
+    if (largest != i) {
+        int temp = arr[i];
+        arr[i] = arr[largest];
+        arr[largest] = temp;
+        
+        MaxHeapify(arr, heap_size, largest);
+    }
+}
+
 void printArray(int arr[], int size) {
     for (int i = 0; i < size; i++) {
         printf("%d ", arr[i]);
@@ -46,6 +504,67 @@ void printArray(int arr[], int size) {
     printf("\n");
 }
 
+bool IsSorted(int arr[], int size) {
+    for (int i = 1; i < size; i++) {
+        if (arr[i - 1] > arr[i]) return false;
+    }
+    
+    return true;
+}
+
+void FillInput(int arr[], int size, int pattern) {
+    for (int i = 0; i < size; i++) {
+        switch (pattern) {
+            case 0: arr[i] = rand(); break;                                 // random
+            case 1: arr[i] = i; break;                                      // sorted
+            case 2: arr[i] = size - i; break;                               // reversed
+            case 3: arr[i] = i < size / 2 ? i : size - i; break;            // organ pipe
+            default: arr[i] = rand() % 10; break;                           // many duplicates
+        }
+    }
+}
+
+// Milliseconds to sort one input, or -1 if the result is not sorted
+double TimeSort(void (*sort)(int[], int), int arr[], int size) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    sort(arr, size);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    if (!IsSorted(arr, size)) return -1;
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+void Benchmark(int size, bool include_classic) {
+    const char *patterns[] = {"random", "sorted", "reversed", "organ pipe", "duplicates"};
+    int *arr = malloc(size * sizeof(int));
+    
+    printf("\n%d elements (ms):\n", size);
+    printf("%-12s %10s %10s", "input", "introsort", "pdqsort");
+    if (include_classic) printf(" %10s", "classic");
+    printf("\n");
+    
+    for (int pattern = 0; pattern < 5; pattern++) {
+        srand(1);
+        FillInput(arr, size, pattern);
+        double intro = TimeSort(QuickSort, arr, size);
+        
+        srand(1);
+        FillInput(arr, size, pattern);
+        double pdq = TimeSort(PdqSort, arr, size);
+        
+        printf("%-12s %10.2f %10.2f", patterns[pattern], intro, pdq);
+        if (include_classic) {
+            srand(1);
+            FillInput(arr, size, pattern);
+            printf(" %10.2f", TimeSort(ClassicQuickSort, arr, size));
+        }
+        printf("\n");
+    }
+    
+    free(arr);
+}
+
 int main() {
     int size = 10;
     int arr[size];
@@ -62,5 +581,10 @@ int main() {
     printf("Array After:\n");
     printArray(arr, size);
     
+    // The classic version is quadratic on most of these, so compare at a size
+    // it can finish, then show introsort alone at scale
+    Benchmark(20000, true);
+    Benchmark(10000000, false);
+    
     return 0;
 }
\ No newline at end of file